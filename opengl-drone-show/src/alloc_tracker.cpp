@@ -0,0 +1,144 @@
+#include "alloc_tracker.h"
+
+#include <cstdlib>
+
+#ifndef TRACK_ALLOCS
+
+bool allocTrackingEnabled() { return false; }
+AllocStats allocStats() { return AllocStats(); }
+void *trackedMalloc(size_t size) { return malloc(size); }
+void trackedFree(void *ptr) { free(ptr); }
+
+#else
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+static std::atomic<uint64_t> allocations{0}, frees{0}, bytesAllocated{0},
+    liveBytes{0}, peakBytes{0};
+
+// Each block starts with a header that records its size. The header is as
+// large as the block's alignment so the pointer handed out stays aligned.
+static const size_t MIN_HEADER = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+static void *allocate(size_t size, size_t alignment) {
+  size_t header = std::max(alignment, MIN_HEADER);
+#ifdef _WIN32
+  void *base = _aligned_malloc(size + header, header);
+#else
+  void *base = nullptr;
+  if (posix_memalign(&base, header, size + header) != 0)
+    base = nullptr;
+#endif
+  if (!base)
+    return nullptr;
+  unsigned char *ptr = (unsigned char *)base + header;
+  ((size_t *)ptr)[-1] = size;
+
+  const std::memory_order relaxed = std::memory_order_relaxed;
+  allocations.fetch_add(1, relaxed);
+  bytesAllocated.fetch_add(size, relaxed);
+  uint64_t live = liveBytes.fetch_add(size, relaxed) + size;
+  uint64_t peak = peakBytes.load(relaxed);
+  while (live > peak && !peakBytes.compare_exchange_weak(peak, live, relaxed)) {
+  }
+  return ptr;
+}
+
+static void deallocate(void *ptr, size_t alignment) {
+  if (!ptr)
+    return;
+  size_t header = std::max(alignment, MIN_HEADER);
+  frees.fetch_add(1, std::memory_order_relaxed);
+  liveBytes.fetch_sub(((size_t *)ptr)[-1], std::memory_order_relaxed);
+  void *base = (unsigned char *)ptr - header;
+#ifdef _WIN32
+  _aligned_free(base);
+#else
+  free(base);
+#endif
+}
+
+static void *allocateOrThrow(size_t size, size_t alignment) {
+  void *ptr = allocate(size, alignment);
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+bool allocTrackingEnabled() { return true; }
+
+AllocStats allocStats() {
+  AllocStats stats;
+  stats.allocations = allocations.load(std::memory_order_relaxed);
+  stats.frees = frees.load(std::memory_order_relaxed);
+  stats.bytesAllocated = bytesAllocated.load(std::memory_order_relaxed);
+  stats.liveBytes = liveBytes.load(std::memory_order_relaxed);
+  stats.peakBytes = peakBytes.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void *trackedMalloc(size_t size) { return allocate(size, 0); }
+void trackedFree(void *ptr) { deallocate(ptr, 0); }
+
+// --- Global Operators ---
+void *operator new(size_t size) { return allocateOrThrow(size, 0); }
+void *operator new[](size_t size) { return allocateOrThrow(size, 0); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size, 0);
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size, 0);
+}
+void *operator new(size_t size, std::align_val_t align) {
+  return allocateOrThrow(size, (size_t)align);
+}
+void *operator new[](size_t size, std::align_val_t align) {
+  return allocateOrThrow(size, (size_t)align);
+}
+void *operator new(size_t size, std::align_val_t align,
+                   const std::nothrow_t &) noexcept {
+  return allocate(size, (size_t)align);
+}
+void *operator new[](size_t size, std::align_val_t align,
+                     const std::nothrow_t &) noexcept {
+  return allocate(size, (size_t)align);
+}
+
+void operator delete(void *ptr) noexcept { deallocate(ptr, 0); }
+void operator delete[](void *ptr) noexcept { deallocate(ptr, 0); }
+void operator delete(void *ptr, size_t) noexcept { deallocate(ptr, 0); }
+void operator delete[](void *ptr, size_t) noexcept { deallocate(ptr, 0); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+  deallocate(ptr, 0);
+}
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+  deallocate(ptr, 0);
+}
+void operator delete(void *ptr, std::align_val_t align) noexcept {
+  deallocate(ptr, (size_t)align);
+}
+void operator delete[](void *ptr, std::align_val_t align) noexcept {
+  deallocate(ptr, (size_t)align);
+}
+void operator delete(void *ptr, size_t, std::align_val_t align) noexcept {
+  deallocate(ptr, (size_t)align);
+}
+void operator delete[](void *ptr, size_t, std::align_val_t align) noexcept {
+  deallocate(ptr, (size_t)align);
+}
+void operator delete(void *ptr, std::align_val_t align,
+                     const std::nothrow_t &) noexcept {
+  deallocate(ptr, (size_t)align);
+}
+void operator delete[](void *ptr, std::align_val_t align,
+                       const std::nothrow_t &) noexcept {
+  deallocate(ptr, (size_t)align);
+}
+
+#endif
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// --- Allocation Tracker ---
+// Opt-in counters for heap allocations made through the global operator new
+// and through trackedMalloc(), which cJSON and ImGui are pointed at. Build
+// with `make TRACK_ALLOCS=1` (after `make clean`) to replace the global
+// operators; otherwise they are the standard ones and
+// allocTrackingEnabled() returns false.
+struct AllocStats {
+  uint64_t allocations = 0;    // Since start
+  uint64_t frees = 0;          // Since start
+  uint64_t bytesAllocated = 0; // Since start
+  uint64_t liveBytes = 0;
+  uint64_t peakBytes = 0;
+};
+
+bool allocTrackingEnabled();
+AllocStats allocStats();
+
+// malloc/free for C libraries, counted like operator new when tracking.
+void *trackedMalloc(size_t size);
+void trackedFree(void *ptr);
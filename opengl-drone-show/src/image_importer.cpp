@@ -0,0 +1,297 @@
+#include "image_importer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "rng.h"
+#include "stb_image.h"
+
+// Sampling tiles are this many grid cells wide. Tiles of the same phase are
+// a whole tile apart, far more than the two-cell neighborhood a sample
+// reads, so they can be filled concurrently.
+static const int TILE_CELLS = 32;
+static const int ATTEMPTS_PER_CELL = 8;
+// A maximal Poisson-disk set with separation r covers an area A with about
+// 0.7 * A / r^2 samples.
+static const float POISSON_DENSITY = 0.7f;
+static const int DEPTH_LAYERS = 30;
+static const float DEPTH_GAP = 10.0f;
+
+struct Sample {
+  float x, y;
+};
+
+// Runs fn(0..count-1) on up to `threads` threads.
+template <typename Fn> static void parallelFor(int count, int threads, Fn fn) {
+  threads = std::max(1, std::min(threads, count));
+  if (threads == 1) {
+    for (int i = 0; i < count; ++i)
+      fn(i);
+    return;
+  }
+  std::atomic<int> next(0);
+  auto worker = [&]() {
+    for (int i = next++; i < count; i = next++)
+      fn(i);
+  };
+  std::vector<std::thread> pool;
+  for (int t = 1; t < threads; ++t)
+    pool.emplace_back(worker);
+  worker();
+  for (auto &thread : pool)
+    thread.join();
+}
+
+// 1 for shape pixels, 0 for background.
+static void buildMask(const unsigned char *rgba, int w, int h, bool hasAlpha,
+                      int threads, std::vector<uint8_t> &mask) {
+  mask.resize((size_t)w * h);
+  parallelFor(h, threads, [&](int y) {
+    const unsigned char *px = rgba + (size_t)y * w * 4;
+    uint8_t *row = &mask[(size_t)y * w];
+    for (int x = 0; x < w; ++x, px += 4) {
+      if (hasAlpha) {
+        row[x] = px[3] > 10;
+      } else {
+        // Same weights as OpenCV's BGR2GRAY
+        float gray = 0.299f * px[0] + 0.587f * px[1] + 0.114f * px[2];
+        row[x] = gray <= 245.0f;
+      }
+    }
+  });
+}
+
+// Marks background that cannot reach the image border as shape, filling
+// holes the way drawing the external contours filled does in the script.
+static void fillHoles(std::vector<uint8_t> &mask, int w, int h) {
+  const uint8_t OUTSIDE = 2;
+  std::vector<int> stack;
+  auto visit = [&](int x, int y) {
+    uint8_t &m = mask[(size_t)y * w + x];
+    if (m == 0) {
+      m = OUTSIDE;
+      stack.push_back(y * w + x);
+    }
+  };
+  for (int x = 0; x < w; ++x) {
+    visit(x, 0);
+    visit(x, h - 1);
+  }
+  for (int y = 0; y < h; ++y) {
+    visit(0, y);
+    visit(w - 1, y);
+  }
+  while (!stack.empty()) {
+    int i = stack.back();
+    stack.pop_back();
+    int x = i % w, y = i / w;
+    if (x > 0)
+      visit(x - 1, y);
+    if (x < w - 1)
+      visit(x + 1, y);
+    if (y > 0)
+      visit(x, y - 1);
+    if (y < h - 1)
+      visit(x, y + 1);
+  }
+  for (auto &m : mask)
+    m = m != OUTSIDE;
+}
+
+// Tiled parallel dart throwing on a background grid with cells of size
+// r / sqrt(2), so every cell holds at most one sample. Tiles are processed
+// in four phases of a 2x2 checkerboard; within a phase no two tiles read or
+// write the same cells.
+static void samplePoissonDisk(const std::vector<uint8_t> &mask, int w, int h,
+                              float r, uint64_t seed, int threads,
+                              std::vector<Sample> &out) {
+  float cellSize = r / std::sqrt(2.0f);
+  int cols = (int)std::ceil(w / cellSize), rows = (int)std::ceil(h / cellSize);
+  std::vector<Sample> cells((size_t)cols * rows, Sample{-1.0f, -1.0f});
+  int tilesX = (cols + TILE_CELLS - 1) / TILE_CELLS;
+  int tilesY = (rows + TILE_CELLS - 1) / TILE_CELLS;
+  float r2 = r * r;
+
+  auto fillTile = [&](int tx, int ty) {
+    // Seeded per tile so results do not depend on thread timing
+    Rng rng(seed * 0x100000001B3ull + (uint64_t)ty * tilesX + tx);
+    int x0 = tx * TILE_CELLS, y0 = ty * TILE_CELLS;
+    int x1 = std::min(x0 + TILE_CELLS, cols), y1 = std::min(y0 + TILE_CELLS, rows);
+    std::vector<int> order;
+    order.reserve((x1 - x0) * (y1 - y0));
+    for (int cy = y0; cy < y1; ++cy)
+      for (int cx = x0; cx < x1; ++cx)
+        order.push_back(cy * cols + cx);
+    for (size_t i = order.size(); i > 1; --i)
+      std::swap(order[i - 1], order[rng.below((uint32_t)i)]);
+
+    for (int cell : order) {
+      int cx = cell % cols, cy = cell / cols;
+      for (int attempt = 0; attempt < ATTEMPTS_PER_CELL; ++attempt) {
+        float x = (cx + rng.uniform()) * cellSize;
+        float y = (cy + rng.uniform()) * cellSize;
+        if (x >= w || y >= h || !mask[(size_t)y * w + (size_t)x])
+          continue;
+        bool tooClose = false;
+        for (int ny = std::max(cy - 2, 0);
+             ny <= std::min(cy + 2, rows - 1) && !tooClose; ++ny) {
+          for (int nx = std::max(cx - 2, 0); nx <= std::min(cx + 2, cols - 1);
+               ++nx) {
+            const Sample &s = cells[(size_t)ny * cols + nx];
+            float dx = s.x - x, dy = s.y - y;
+            if (s.x >= 0.0f && dx * dx + dy * dy < r2) {
+              tooClose = true;
+              break;
+            }
+          }
+        }
+        if (!tooClose) {
+          cells[cell] = {x, y};
+          break;
+        }
+      }
+    }
+  };
+
+  for (int phase = 0; phase < 4; ++phase) {
+    int px = phase & 1, py = phase >> 1;
+    int countX = (tilesX - px + 1) / 2, countY = (tilesY - py + 1) / 2;
+    parallelFor(countX * countY, threads, [&](int i) {
+      fillTile(px + 2 * (i % countX), py + 2 * (i / countX));
+    });
+  }
+
+  out.clear();
+  for (const Sample &s : cells)
+    if (s.x >= 0.0f)
+      out.push_back(s);
+}
+
+static std::string fileStem(const std::string &path) {
+  size_t slash = path.find_last_of("/\\");
+  std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+  size_t dot = name.find_last_of('.');
+  return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+bool importImageLayer(const char *path, const ImageImportOptions &options,
+                      DroneLayer &layer, ImageImportStats &stats,
+                      std::string &error) {
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now();
+  stats = ImageImportStats();
+  if (options.droneCount <= 0) {
+    error = "Drone count must be positive";
+    return false;
+  }
+  int threads = options.threads > 0
+                    ? options.threads
+                    : (int)std::max(1u, std::thread::hardware_concurrency());
+
+  int w, h, channels;
+  unsigned char *rgba = stbi_load(path, &w, &h, &channels, 4);
+  if (!rgba) {
+    error = std::string("Could not read image: ") + stbi_failure_reason();
+    return false;
+  }
+  stats.width = w;
+  stats.height = h;
+
+  std::vector<uint8_t> mask;
+  buildMask(rgba, w, h, channels == 2 || channels == 4, threads, mask);
+  fillHoles(mask, w, h);
+
+  int minX = w, minY = h, maxX = -1, maxY = -1, maskPixels = 0;
+  for (int y = 0; y < h; ++y) {
+    const uint8_t *row = &mask[(size_t)y * w];
+    for (int x = 0; x < w; ++x) {
+      if (row[x]) {
+        ++maskPixels;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+      }
+    }
+  }
+  stats.maskPixels = maskPixels;
+  if (maskPixels == 0) {
+    stbi_image_free(rgba);
+    error = "No shape found (image is empty or all background)";
+    return false;
+  }
+  float shapeW = (float)(maxX + 1 - minX), shapeH = (float)(maxY + 1 - minY);
+  float worldPerPixel = options.maxSize / std::max(shapeW, shapeH);
+
+  // Start from the separation that should just fit the requested count and
+  // tighten it until enough samples fit, unless the caller asked for a
+  // minimum separation that cannot be met. At most one drone per shape pixel
+  // is asked for and the separation never drops below a pixel, which bounds
+  // the sampling grid by the image size.
+  int target = std::min(std::min(options.droneCount, IMPORT_MAX_DRONES),
+                        maskPixels);
+  stats.droneLimit = target;
+  float minRadius = std::max(options.minSeparation / worldPerPixel,
+                             IMPORT_MIN_SEPARATION_PIXELS);
+  float radius = std::max(
+      std::sqrt(POISSON_DENSITY * maskPixels / target), minRadius);
+  std::vector<Sample> samples;
+  for (int attempt = 0; attempt < 6; ++attempt) {
+    samplePoissonDisk(mask, w, h, radius, options.seed + attempt, threads,
+                      samples);
+    if ((int)samples.size() >= target || radius <= minRadius)
+      break;
+    float shrink = samples.empty()
+                       ? 0.5f
+                       : 0.97f * std::sqrt((float)samples.size() / target);
+    radius = std::max(radius * shrink, minRadius);
+  }
+  stats.separation = radius * worldPerPixel;
+
+  // Drop the surplus at random; removing samples keeps the separation.
+  Rng rng(options.seed);
+  size_t keep = std::min(samples.size(), (size_t)target);
+  for (size_t i = 0; i < keep; ++i)
+    std::swap(samples[i],
+              samples[i + rng.below((uint32_t)(samples.size() - i))]);
+  samples.resize(keep);
+
+  // Color-to-depth layering from the script: distinct colors in sorted
+  // order are spread over DEPTH_LAYERS planes.
+  std::vector<uint32_t> colors(samples.size());
+  for (size_t i = 0; i < samples.size(); ++i) {
+    const unsigned char *px =
+        rgba + ((size_t)samples[i].y * w + (size_t)samples[i].x) * 4;
+    colors[i] = (uint32_t)px[0] << 16 | (uint32_t)px[1] << 8 | px[2];
+  }
+  std::vector<uint32_t> palette = colors;
+  std::sort(palette.begin(), palette.end());
+  palette.erase(std::unique(palette.begin(), palette.end()), palette.end());
+
+  layer.id = "image_" + fileStem(path);
+  layer.name = fileStem(path);
+  layer.duration = options.duration;
+  layer.points.resize(samples.size());
+  for (size_t i = 0; i < samples.size(); ++i) {
+    size_t rank = std::lower_bound(palette.begin(), palette.end(), colors[i]) -
+                  palette.begin();
+    DronePoint &p = layer.points[i];
+    // Center the shape on the origin; image Y grows downwards.
+    p.pos.x = (samples[i].x - minX - shapeW / 2.0f) * worldPerPixel;
+    p.pos.y = -(samples[i].y - minY - shapeH / 2.0f) * worldPerPixel;
+    p.pos.z = (rank % DEPTH_LAYERS) * DEPTH_GAP;
+    p.color = {((colors[i] >> 16) & 0xFF) / 255.0f,
+               ((colors[i] >> 8) & 0xFF) / 255.0f, (colors[i] & 0xFF) / 255.0f,
+               1.0f};
+  }
+  stbi_image_free(rgba);
+
+  stats.milliseconds =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  return true;
+}
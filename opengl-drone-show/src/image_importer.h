@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+
+#include "show_types.h"
+
+// --- Image Import ---
+// Turns a PNG (or any format stb_image reads) into a drone formation, the
+// native replacement for assets/generation/index.py:
+//   1. mask: alpha > 10, or anything darker than near-white (gray <= 245)
+//      when the image has no alpha channel; holes inside the shape are
+//      filled like the script's external contour fill
+//   2. blue-noise (Poisson-disk) sampling of the mask on all cores, so
+//      drones keep a minimum separation instead of clumping
+//   3. color taken from the image, depth from the script's color layering
+//      (distinct colors sorted and spread over 30 planes 10 units apart)
+// Caps that keep a mistyped drone count from sizing the sampling grid (about
+// two cells per shape pixel at the smallest separation) beyond reason
+const int IMPORT_MAX_DRONES = 1000000;
+const float IMPORT_MIN_SEPARATION_PIXELS = 1.0f;
+
+struct ImageImportOptions {
+  int droneCount = 10000;      // Clamped to IMPORT_MAX_DRONES
+  float maxSize = 600.0f;      // World size of the longer side of the shape
+  float minSeparation = 0.0f;  // World units; 0 derives it from droneCount
+  int duration = 3000;         // Layer duration in milliseconds
+  unsigned int seed = 1;
+  int threads = 0;             // 0 = one per hardware thread
+};
+
+struct ImageImportStats {
+  int width = 0, height = 0;
+  int maskPixels = 0;
+  int droneLimit = 0;      // Requested count after the caps (<= maskPixels)
+  float separation = 0.0f; // Achieved minimum separation in world units
+  double milliseconds = 0.0;
+};
+
+// Builds `layer` from the image at `path`. On failure returns false and
+// describes the problem in `error`.
+bool importImageLayer(const char *path, const ImageImportOptions &options,
+                      DroneLayer &layer, ImageImportStats &stats,
+                      std::string &error);
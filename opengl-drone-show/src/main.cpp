@@ -1,12 +1,27 @@
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <time.h>
 #include <vector>
 
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
 #define GLEW_STATIC
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -19,133 +34,52 @@
 #include "cJSON.h"
 #include "stb_image.h"
 
-// --- Math & Easing ---
-const float PI = 3.1415926535f;
-struct Vec3 {
-  float x, y, z;
-};
-struct Vec4 {
-  float x, y, z, w;
-};
-Vec3 operator+(Vec3 a, Vec3 b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
-Vec3 operator-(Vec3 a, Vec3 b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
-Vec3 operator*(Vec3 a, float s) { return {a.x * s, a.y * s, a.z * s}; }
-float dot(Vec3 a, Vec3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
-Vec3 cross(Vec3 a, Vec3 b) {
-  return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
-}
-Vec3 normalize(Vec3 v) {
-  float mag = sqrt(dot(v, v));
-  if (mag > 0.0001f)
-    return v * (1.0f / mag);
-  return {0, 0, 0};
-}
-Vec3 lerp(Vec3 start, Vec3 end, float t) {
-  return start * (1.0f - t) + end * t;
-}
-Vec4 lerp(Vec4 start, Vec4 end, float t) {
-  return {start.x * (1.0f - t) + end.x * t, start.y * (1.0f - t) + end.y * t,
-          start.z * (1.0f - t) + end.z * t, start.w * (1.0f - t) + end.w * t};
-}
-Vec3 naturalLerp(Vec3 start, Vec3 end, float t, int droneIndex) {
-  Vec3 lerpedPos = lerp(start, end, t);
-  if (t > 0.01f && t < 0.99f) { // Avoid deviation at start and end
-    float frequency = 2.0f;
-    float magnitude =
-        20.0f * (1.0f - pow(2.0f * t - 1.0f,
-                            4.0f)); // Strongest deviation in the middle
-
-    Vec3 path = end - start;
-    Vec3 randomDir = {(float)sin(droneIndex * 2.3f),
-                      (float)cos(droneIndex * 5.1f),
-                      (float)sin(droneIndex * 1.7f)};
-    Vec3 perpendicular = normalize(cross(path, randomDir));
-    if (dot(perpendicular, perpendicular) <
-        0.1f) { // Handle case where path and randomDir are parallel
-      perpendicular = normalize(cross(path, {1, 0, 0}));
-      if (dot(perpendicular, perpendicular) < 0.1f) {
-        perpendicular = normalize(cross(path, {0, 1, 0}));
-      }
-    }
-
-    lerpedPos = lerpedPos + perpendicular * magnitude * sin(t * PI);
-  }
-  return lerpedPos;
-}
-float easeOutCubic(float t) { return 1.0f - pow(1.0f - t, 3.0f); }
+#include "alloc_tracker.h"
+#include "image_importer.h"
+#include "motion_trails.h"
+#include "quality_governor.h"
+#include "rng.h"
+#include "show_arena.h"
+#include "show_format.h"
+#include "show_types.h"
+#include "thumbnail_atlas.h"
+#include "trajectory_cache.h"
+#include "triple_buffer.h"
+#include "vec_math.h"
+
+// --- View ---
+enum ViewMode { VIEW_3D, VIEW_2D_TOP, VIEW_2D_FRONT };
 
-struct Mat4 {
-  float m[16] = {0};
-};
-Mat4 identity() {
-  Mat4 mat;
-  mat.m[0] = 1.0f;
-  mat.m[5] = 1.0f;
-  mat.m[10] = 1.0f;
-  mat.m[15] = 1.0f;
-  return mat;
-}
-Mat4 perspective(float fov, float aspect, float n, float f) {
-  Mat4 mat;
-  float t = tan(fov / 2.0f);
-  mat.m[0] = 1.0f / (aspect * t);
-  mat.m[5] = 1.0f / t;
-  mat.m[10] = -(f + n) / (f - n);
-  mat.m[11] = -1.0f;
-  mat.m[14] = -(2.0f * f * n) / (f - n);
-  return mat;
-}
-Mat4 orthographic(float l, float r, float b, float t, float n, float f) {
-  Mat4 mat = identity();
-  mat.m[0] = 2.0f / (r - l);
-  mat.m[5] = 2.0f / (t - b);
-  mat.m[10] = -2.0f / (f - n);
-  mat.m[12] = -(r + l) / (r - l);
-  mat.m[13] = -(t + b) / (t - b);
-  mat.m[14] = -(f + n) / (f - n);
-  return mat;
-}
-Mat4 lookAt(Vec3 eye, Vec3 center, Vec3 up) {
-  Vec3 f = normalize(center - eye);
-  Vec3 s = normalize(cross(f, up));
-  Vec3 u = cross(s, f);
-  Mat4 mat = identity();
-  mat.m[0] = s.x;
-  mat.m[4] = s.y;
-  mat.m[8] = s.z;
-  mat.m[1] = u.x;
-  mat.m[5] = u.y;
-  mat.m[9] = u.z;
-  mat.m[2] = -f.x;
-  mat.m[6] = -f.y;
-  mat.m[10] = -f.z;
-  mat.m[12] = -dot(s, eye);
-  mat.m[13] = -dot(u, eye);
-  mat.m[14] = dot(f, eye);
-  return mat;
-}
-
-// --- Data Structures ---
-struct DronePoint {
-  Vec3 pos;
-  Vec4 color;
+struct ViewCamera {
+  ViewMode mode = VIEW_3D;
+  Vec3 target = {0, 0, 0};
+  float yaw = -PI / 2.0f, pitch = 0.0f, radius = 500.0f; // For 3D orbit
+  float orthoSize = 500.0f;                               // For 2D zoom
 };
-struct DroneLayer {
-  std::string id;
-  std::string name;
-  int duration;
-  std::vector<DronePoint> points;
+
+// Per-view uniforms, laid out like the std140 ViewBlock in shader.geom.
+struct ViewUniforms {
+  Mat4 viewProjection;
+  Vec4 cameraRight, cameraUp; // xyz used
+  Vec4 cull; // x: viewport height in pixels, y: smallest sprite drawn
 };
-struct DroneShow {
-  std::string title;
-  std::vector<DroneLayer> layers;
+
+// A rectangle of the window showing one camera.
+struct ViewPane {
+  ViewCamera *camera;
+  const char *label;
+  float x, y, w, h; // Fraction of the window, origin top-left
+  int pixelX, pixelY, pixelW, pixelH; // Render target pixels, origin bottom-left
+  Mat4 view, projection;
 };
-enum ViewMode { VIEW_3D, VIEW_2D_TOP, VIEW_2D_FRONT };
 
 // --- Globals ---
-DroneShow droneShow;
-DroneLayer groundFormation;
+ShowArena showArena; // Owns droneShow and groundFormation, see releaseShow()
+DroneShow droneShow = {std::pmr::string(&showArena),
+                       std::pmr::vector<DroneLayer>(&showArena)};
+DroneLayer groundFormation(&showArena);
 std::vector<float> vertexData;
+std::vector<Vec4> clipPositions; // Scratch space for view culling
 std::vector<DronePoint> animationBuffer;
 int currentLayer = 0, previousLayer = 0;
 bool isPlaying = false;
@@ -153,6 +87,7 @@ float timelinePosition = 0.0f, totalDuration = 0.0f, elapsedTime = 0.0f;
 float playbackSpeed = 1.0f;
 int visibleDroneCount = -1; // -1 for all
 int maxDronesInShow = 0;
+const int MIN_DRONE_COUNT = 2500; // The fleet is never smaller than this
 GLuint droneTexture;
 GLuint droneShaderProgram;
 float droneSize = 5.0f;
@@ -171,17 +106,121 @@ struct Particle {
   Vec3 vel;
   Vec4 color;
   float lifetime;
+  int slot; // Spawn index, kept while others die (motion trail slot)
 };
 std::vector<Particle> particles;
 bool enableFireworks = false;
+int particleBudget = 0; // Copied from the quality governor
+// Largest finale spawnFireworks() can produce: 15 explosions of up to 149
+const int MAX_FIREWORK_PARTICLES = 15 * 149;
+
+// --- Performance State ---
+QualityGovernor governor;
+GpuTimer gpuTimer;
+RenderTarget sceneTarget;
+int dronesCulled = 0;
+uint64_t lastFrameAllocations = 0; // Heap allocations in the last frame
+
+// --- Motion Trails ---
+// Drone i records into trail slot i, firework particles into the slots after
+// the fleet. The rows are built here and recorded on the GPU by `trails`.
+MotionTrails trails;
+bool enableTrails = false;
+GLuint trailShaderProgram;
+std::vector<Vec4> trailPositions; // This frame's row, w = alpha
+std::vector<uint32_t> trailColors;
+unsigned int trailGeneration = 0; // Snapshot generation the trails follow
+std::string trailStatus; // Why the trails were turned off, for the UI
+
+// --- Layer Thumbnails ---
+ThumbnailAtlas thumbnails;
+GLuint thumbnailShaderProgram;
+unsigned int showRevision = 0; // Bumped per loaded show, redraws every tile
+int thumbnailStripLayer = -1;  // Layer the strip last scrolled to
+
+// --- Simulation Thread ---
+// The show advances in fixed SIM_DT steps on its own thread, so frame rate,
+// vsync stalls and UI work no longer change drone timing, and a seed
+// reproduces the same show. While the thread runs it owns the show state
+// above: the render thread only posts SimCommands and reads the published
+// SimSnapshots. Loading or importing stops the thread first.
+const double SIM_DT = 1.0 / 60.0;
+// After a stall the simulation catches up at most this many ticks, then
+// slows down instead of falling further behind.
+const int SIM_MAX_CATCH_UP_TICKS = 8;
+
+enum SimCommandType {
+  SIM_SET_PLAYING,
+  SIM_SEEK,
+  SIM_SET_SPEED,
+  SIM_TRANSITION_TO,
+  SIM_SET_VISIBLE_DRONES,
+  SIM_SET_FIREWORKS,
+  SIM_SET_PARTICLE_BUDGET,
+};
+struct SimCommand {
+  SimCommandType type;
+  float value;
+};
+
+// Everything the render thread needs from one simulation tick.
+struct SimSnapshot {
+  std::vector<DronePoint> drones; // Visible drones only
+  std::vector<Particle> particles;
+  int currentLayer = 0;
+  int visibleDroneCount = 0;
+  bool isPlaying = false;
+  bool enableFireworks = false;
+  float timelinePosition = 0.0f;
+  float playbackSpeed = 1.0f;
+  double time = 0.0;           // Clock time of the tick, in seconds
+  unsigned int generation = 0; // Changes when drones jump (reset to ground)
+  float tickMs = 0.0f;         // CPU time of one tick
+};
+
+unsigned int simSeed = 1;
+Rng simRng;
+unsigned int simGeneration = 0;
+std::thread simThread;
+std::atomic<bool> simRunning(false);
+std::mutex simCommandMutex;
+std::vector<SimCommand> simCommands, simCommandsInFlight;
+TripleBuffer<SimSnapshot> simSnapshots;
+// Render thread only: the two newest snapshots and the blend of both
+SimSnapshot previousSnapshot, currentSnapshot;
+std::vector<DronePoint> renderDrones;
+std::vector<Particle> renderParticles;
+
+// --- Baked Playback State ---
+// A show opened from a .dbake file is decoded frame by frame on the
+// simulation thread instead of being simulated; one tick shows one frame.
+TrajectoryDecoder bakedShow;
+int bakedFrame = 0;
+bool bakedFrameDirty = false; // Sought while paused
+const float BAKE_POSITION_STEP = 1.0f / 128.0f;
+
+// --- Image Import State ---
+ImageImportOptions importOptions;
+std::string importStatus;
+char importPath[512] = "";
+std::string importBrowseDir = ".";
+std::vector<std::pair<std::string, bool>> importBrowseEntries; // name, is dir
+bool importBrowseDirty = true;
 
 // --- Camera & Mouse State ---
-ViewMode currentViewMode = VIEW_3D;
-Vec3 cameraTarget = {0, 0, 0};
-float cameraYaw = -PI / 2.0f, cameraPitch = 0.0f,
-      cameraRadius = 500.0f; // For 3D orbit
-float orthoSize = 500.0f;    // For 2D zoom
-bool isDragging = false;
+// The single view uses mainCamera. Split screen shows the 3D, top and front
+// cameras plus up to MAX_VIEWS - 3 extra orbit cameras in a grid. Every pane
+// draws the same uploaded vertexData; only the per-view uniform block and
+// the viewport change between them.
+const int MAX_VIEWS = 8;
+ViewCamera mainCamera;
+ViewCamera splitCameras[MAX_VIEWS];
+bool splitScreen = false;
+int splitViewCount = 3;
+std::vector<ViewPane> viewPanes;
+std::vector<unsigned char> viewUniformData; // One block per pane
+int viewUniformStride = 256; // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT rounded up
+ViewCamera *dragCamera = nullptr; // Camera of the pane being dragged
 double lastMouseX = 0, lastMouseY = 0;
 
 // --- Forward Declarations ---
@@ -191,6 +230,8 @@ void mouse_button_callback(GLFWwindow *window, int button, int action,
                            int mods);
 void cursor_position_callback(GLFWwindow *window, double xpos, double ypos);
 void spawnFireworks();
+void startSimulation();
+bool stopSimulation();
 GLuint createShaderProgram(const char *vsPath, const char *fsPath,
                            const char *gsPath = nullptr);
 GLuint loadTexture(const char *path);
@@ -302,30 +343,60 @@ GLuint createShaderProgram(const char *vsPath, const char *fsPath,
   return program;
 }
 
-void loadDroneShow(const char *path) {
-  droneShow.layers.clear();
-  totalDuration = 0;
-  elapsedTime = 0;
-  currentLayer = 0;
-  previousLayer = 0;
-  visibleDroneCount = -1;
-  maxDronesInShow = 0;
+// Arena bytes for a show with the given totals, including the ground
+// formation, plus some slack per allocation for alignment.
+size_t showArenaBytes(size_t layerCount, size_t pointCount, size_t maxPoints,
+                      size_t textBytes) {
+  const size_t SLACK = 64;
+  size_t fleet = std::max(maxPoints, (size_t)MIN_DRONE_COUNT);
+  return layerCount * (sizeof(DroneLayer) + 3 * SLACK) +
+         (pointCount + fleet) * sizeof(DronePoint) + textBytes + 4 * SLACK;
+}
+
+// Empties the show and the ground formation and hands all of their memory
+// back to the arena at once.
+void releaseShow() {
+  droneShow.title = std::pmr::string(&showArena);
+  droneShow.layers = std::pmr::vector<DroneLayer>(&showArena);
+  groundFormation = DroneLayer(&showArena);
+  showArena.release();
+}
+
+// Parses a JSON show file into droneShow.
+bool parseShowJson(const char *path) {
   std::string jsonString = readFile(path);
   if (jsonString.empty())
-    return;
+    return false;
   cJSON *root = cJSON_Parse(jsonString.c_str());
   if (!root)
-    return;
-  droneShow.title = cJSON_GetObjectItem(root, "title")->valuestring;
+    return false;
+  const char *title = cJSON_GetObjectItem(root, "title")->valuestring;
   cJSON *layers = cJSON_GetObjectItem(root, "layers");
   cJSON *layer;
+
+  // Size the arena from the parsed tree, then build the layers in place
+  size_t layerCount = 0, pointCount = 0, maxPoints = 0;
+  size_t textBytes = strlen(title) + 1;
+  cJSON_ArrayForEach(layer, layers) {
+    size_t points = cJSON_GetArraySize(cJSON_GetObjectItem(layer, "points"));
+    ++layerCount;
+    pointCount += points;
+    maxPoints = std::max(maxPoints, points);
+    textBytes += strlen(cJSON_GetObjectItem(layer, "id")->valuestring) +
+                 strlen(cJSON_GetObjectItem(layer, "name")->valuestring) + 2;
+  }
+  showArena.reserve(
+      showArenaBytes(layerCount, pointCount, maxPoints, textBytes));
+
+  droneShow.title = title;
+  droneShow.layers.reserve(layerCount);
   cJSON_ArrayForEach(layer, layers) {
-    DroneLayer l;
+    DroneLayer &l = droneShow.layers.emplace_back();
     l.id = cJSON_GetObjectItem(layer, "id")->valuestring;
     l.name = cJSON_GetObjectItem(layer, "name")->valuestring;
     l.duration = cJSON_GetObjectItem(layer, "duration")->valueint;
-    totalDuration += l.duration;
     cJSON *points = cJSON_GetObjectItem(layer, "points");
+    l.points.reserve(cJSON_GetArraySize(points));
     cJSON *point;
     cJSON_ArrayForEach(point, points) {
       DronePoint p;
@@ -335,29 +406,154 @@ void loadDroneShow(const char *path) {
       parseColor(cJSON_GetObjectItem(point, "color")->valuestring, p.color);
       l.points.push_back(p);
     }
-    droneShow.layers.push_back(l);
-    if (l.points.size() > (size_t)maxDronesInShow) {
-      maxDronesInShow = l.points.size();
-    }
-    // Ensure at least 2500 drones
-    if (maxDronesInShow < 2500)
-      maxDronesInShow = 2500;
   }
   cJSON_Delete(root);
+  return true;
+}
+
+// Parses a binary .dshow file (see show_format.h) into droneShow.
+bool parseShowBinary(const char *path) {
+  std::ifstream f(path, std::ios::binary | std::ios::ate);
+  uint64_t fileSize = f ? (uint64_t)f.tellg() : 0;
+  f.seekg(0);
+  ShowFileHeader header;
+  if (!f.read((char *)&header, sizeof(header)) ||
+      memcmp(header.magic, SHOW_FILE_MAGIC, 4) != 0 ||
+      header.version != SHOW_FILE_VERSION)
+    return false;
+
+  // Walk the layer headers once to size the arena. Every length and count
+  // has to fit in what is left of the file, so a truncated or corrupt file
+  // is rejected here before anything is allocated from it.
+  uint64_t remaining = fileSize - sizeof(header);
+  if (header.titleLength > remaining)
+    return false;
+  remaining -= header.titleLength;
+  if (header.layerCount > remaining / sizeof(ShowLayerHeader))
+    return false;
+  size_t pointCount = 0, maxPoints = 0, textBytes = header.titleLength + 1;
+  f.seekg(header.titleLength, std::ios::cur);
+  for (uint32_t l = 0; l < header.layerCount; ++l) {
+    ShowLayerHeader layerHeader;
+    if (!f.read((char *)&layerHeader, sizeof(layerHeader)))
+      return false;
+    uint64_t layerBytes =
+        sizeof(layerHeader) + (uint64_t)layerHeader.idLength +
+        layerHeader.nameLength +
+        (uint64_t)layerHeader.pointCount * sizeof(ShowPointRecord);
+    if (layerBytes > remaining)
+      return false;
+    remaining -= layerBytes;
+    pointCount += layerHeader.pointCount;
+    maxPoints = std::max(maxPoints, (size_t)layerHeader.pointCount);
+    textBytes += layerHeader.idLength + layerHeader.nameLength + 2;
+    f.seekg(layerHeader.idLength + layerHeader.nameLength +
+                (std::streamoff)layerHeader.pointCount *
+                    sizeof(ShowPointRecord),
+            std::ios::cur);
+  }
+  showArena.reserve(
+      showArenaBytes(header.layerCount, pointCount, maxPoints, textBytes));
+  f.clear();
+  f.seekg(sizeof(header));
+
+  droneShow.title.resize(header.titleLength);
+  if (!f.read(&droneShow.title[0], header.titleLength))
+    return false;
+
+  std::vector<ShowPointRecord> records;
+  records.reserve(maxPoints);
+  droneShow.layers.resize(header.layerCount);
+  for (auto &l : droneShow.layers) {
+    ShowLayerHeader layerHeader;
+    if (!f.read((char *)&layerHeader, sizeof(layerHeader)))
+      return false;
+    l.id.resize(layerHeader.idLength);
+    l.name.resize(layerHeader.nameLength);
+    if (!f.read(&l.id[0], layerHeader.idLength) ||
+        !f.read(&l.name[0], layerHeader.nameLength))
+      return false;
+    l.duration = layerHeader.duration;
+
+    records.resize(layerHeader.pointCount);
+    if (!f.read((char *)records.data(),
+                records.size() * sizeof(ShowPointRecord)))
+      return false;
+    l.points.resize(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+      const ShowPointRecord &r = records[i];
+      l.points[i].pos = {r.x, r.y, r.z};
+      l.points[i].color = {r.r / 255.0f, r.g / 255.0f, r.b / 255.0f,
+                           r.a / 255.0f};
+    }
+  }
+  return true;
+}
 
-  // Create a "ground" formation
-  groundFormation.points.clear();
+// Opens a baked trajectory file. Its layers only carry names and durations;
+// drone positions come from the decoded frames.
+bool loadBakedShow(const char *path) {
+  std::string error;
+  if (!bakedShow.open(path, error)) {
+    std::cerr << error << std::endl;
+    return false;
+  }
+  size_t textBytes = bakedShow.title.size() + 1;
+  for (const std::string &name : bakedShow.layerNames)
+    textBytes += 2 * (name.size() + 1);
+  showArena.reserve(
+      showArenaBytes(bakedShow.layerNames.size(), 0, 0, textBytes));
+  droneShow.title = bakedShow.title;
+  droneShow.layers.reserve(bakedShow.layerNames.size());
+  for (size_t l = 0; l < bakedShow.layerNames.size(); ++l) {
+    DroneLayer &layer = droneShow.layers.emplace_back();
+    layer.id = layer.name = bakedShow.layerNames[l];
+    layer.duration = bakedShow.layerDurations[l];
+  }
+  return true;
+}
+
+// Decodes bakedFrame into animationBuffer along with the layer and drone
+// count recorded for it.
+void showBakedFrame() {
+  if (!bakedShow.readFrame(bakedFrame, animationBuffer)) {
+    std::cerr << "Failed to decode baked frame " << bakedFrame << std::endl;
+    isPlaying = false;
+    return;
+  }
+  const BakeFrameEntry &entry = bakedShow.index[bakedFrame];
+  currentLayer = entry.layer;
+  visibleDroneCount = entry.visibleDrones;
+  timelinePosition = bakedFrame / (float)std::max(bakedShow.frameCount() - 1, 1);
+}
+
+void seekBaked(int frame) {
+  bakedFrame = std::min(std::max(frame, 0), bakedShow.frameCount() - 1);
+  bakedFrameDirty = true;
+  ++simGeneration; // Do not blend across the jump
+}
+
+bool isBinaryShowFile(const char *path) {
+  std::ifstream f(path, std::ios::binary);
+  char magic[4] = {0};
+  f.read(magic, 4);
+  return f && memcmp(magic, SHOW_FILE_MAGIC, 4) == 0;
+}
+
+// Lays the whole fleet out on a grid below the stage, colored like the first
+// formation they will fly to.
+void buildGroundFormation() {
   int drones = maxDronesInShow;
-  int grid_size = ceil(sqrt(drones));
+  groundFormation.points.resize(drones);
+  int grid_size = std::ceil(std::sqrt((float)drones));
   float spacing = std::max(10.0f, droneSize * 4.0f);
   // Get colors from the first layer if available
-  std::vector<DronePoint> targetPoints;
-  if (!droneShow.layers.empty()) {
-    targetPoints = droneShow.layers[0].points;
-  }
+  static const std::pmr::vector<DronePoint> noPoints;
+  const auto &targetPoints =
+      droneShow.layers.empty() ? noPoints : droneShow.layers[0].points;
 
   for (int i = 0; i < drones; ++i) {
-    DronePoint p;
+    DronePoint &p = groundFormation.points[i];
     p.pos.x = (i % grid_size - (grid_size - 1) / 2.0f) * spacing;
     p.pos.y = -200.0f;
     p.pos.z = (i / grid_size - (grid_size - 1) / 2.0f) * spacing;
@@ -367,29 +563,154 @@ void loadDroneShow(const char *path) {
     } else {
       p.color = {0.2f, 0.2f, 0.2f, 1.0f}; // Visible dark gray
     }
-    groundFormation.points.push_back(p);
   }
+}
+
+// Puts every drone back on the ground, ready for the pre-takeoff countdown.
+void resetToGround() {
+  isPlaying = false;
+  initialAnimationState = PRE_TAKEOFF;
+  preTakeoffTime = 0.0f;
+  transitionElapsedTime = 0.0f;
+  inTransition = false;
+  currentLayer = 0;
+  previousLayer = 0;
+  timelinePosition = 0.0f;
+  elapsedTime = 0.0f;
+  ++simGeneration;
+  // Reuses the buffer: this also runs after every fireworks finale
+  animationBuffer.resize(maxDronesInShow);
+  std::copy_n(groundFormation.points.begin(),
+              std::min(groundFormation.points.size(), animationBuffer.size()),
+              animationBuffer.begin());
+  visibleDroneCount = maxDronesInShow;
+}
+
+void loadDroneShow(const char *path) {
+  releaseShow();
+  ++showRevision;
+  totalDuration = 0;
+  elapsedTime = 0;
+  currentLayer = 0;
+  previousLayer = 0;
+  visibleDroneCount = -1;
+  maxDronesInShow = 0;
+  simRng = Rng(simSeed);
+  bakedShow.close();
+  bool loaded;
+  if (isBakedTrajectoryFile(path))
+    loaded = loadBakedShow(path);
+  else
+    loaded =
+        isBinaryShowFile(path) ? parseShowBinary(path) : parseShowJson(path);
+  if (!loaded) {
+    std::cerr << "Failed to load drone show: " << path << std::endl;
+    droneShow.layers.clear();
+  }
+  for (const auto &l : droneShow.layers) {
+    totalDuration += l.duration;
+    if (l.points.size() > (size_t)maxDronesInShow) {
+      maxDronesInShow = l.points.size();
+    }
+  }
+  if (bakedShow.isOpen()) {
+    maxDronesInShow = bakedShow.header.droneCount;
+    groundFormation.points.clear();
+    particles.clear();
+    animationBuffer.assign(maxDronesInShow, DronePoint());
+    initialAnimationState = DONE;
+    inTransition = false;
+    bakedFrame = 0;
+    ++simGeneration;
+    showBakedFrame();
+    isPlaying = true;
+    return;
+  }
+  // Ensure at least MIN_DRONE_COUNT drones
+  if (maxDronesInShow < MIN_DRONE_COUNT)
+    maxDronesInShow = MIN_DRONE_COUNT;
 
+  buildGroundFormation();
   if (!droneShow.layers.empty()) {
-    animationBuffer.assign(groundFormation.points.begin(),
-                           groundFormation.points.end());
-    animationBuffer.resize(maxDronesInShow);
-
-    visibleDroneCount = maxDronesInShow;
-    initialAnimationState = PRE_TAKEOFF;
-    preTakeoffTime = 0.0f;
-    transitionElapsedTime = 0.0f;
-    currentLayer = 0;
-    previousLayer = 0;
-    isPlaying = false;
-    timelinePosition = 0.0f;
-    elapsedTime = 0.0f;
+    resetToGround();
   } else {
     animationBuffer.clear();
     visibleDroneCount = 0;
   }
 }
 
+// Adds a formation to the end of the loaded show. The fleet grows when the
+// new layer needs more drones than any existing one.
+void appendLayer(const DroneLayer &layer) {
+  bool wasEmpty = droneShow.layers.empty();
+  droneShow.layers.push_back(layer);
+  totalDuration += layer.duration;
+  bool grew = layer.points.size() > (size_t)maxDronesInShow;
+  if (grew)
+    maxDronesInShow = layer.points.size();
+  // Same minimum fleet as a loaded show
+  if (maxDronesInShow < MIN_DRONE_COUNT) {
+    maxDronesInShow = MIN_DRONE_COUNT;
+    grew = true;
+  }
+  if (grew || wasEmpty)
+    buildGroundFormation();
+
+  if (wasEmpty || initialAnimationState == PRE_TAKEOFF) {
+    resetToGround();
+  } else {
+    // Extra drones wait hidden below the stage, like unused drones do after
+    // a transition.
+    animationBuffer.resize(maxDronesInShow,
+                           DronePoint{{0, -200.0f, 0}, {0, 0, 0, 0}});
+  }
+  timelinePosition = totalDuration > 0 ? elapsedTime / totalDuration : 0;
+}
+
+// Imports an image as a new layer at the end of the show. The outcome is
+// kept in importStatus for the UI and echoed to the console.
+bool importImage(const char *path) {
+  if (bakedShow.isOpen()) {
+    importStatus = "Images cannot be added to a baked show";
+    std::cerr << importStatus << std::endl;
+    return false;
+  }
+  DroneLayer layer;
+  ImageImportStats stats;
+  std::string error;
+  if (!importImageLayer(path, importOptions, layer, stats, error)) {
+    importStatus = error;
+    std::cerr << "Image import failed: " << path << ": " << error << std::endl;
+    return false;
+  }
+  bool wasRunning = stopSimulation();
+  appendLayer(layer);
+  if (wasRunning)
+    startSimulation();
+  char message[256];
+  snprintf(message, sizeof(message),
+           "Imported '%s': %d drones from %dx%d in %.0f ms (spacing %.2f)",
+           layer.name.c_str(), (int)layer.points.size(), stats.width,
+           stats.height, stats.milliseconds, stats.separation);
+  importStatus = message;
+  // The image or the spacing can leave no room for every requested drone
+  if (stats.droneLimit < importOptions.droneCount) {
+    snprintf(message, sizeof(message),
+             "; requested %d, limited to %d (%s)", importOptions.droneCount,
+             stats.droneLimit,
+             stats.droneLimit == stats.maskPixels ? "one per shape pixel"
+                                                  : "import maximum");
+    importStatus += message;
+  } else if ((int)layer.points.size() < importOptions.droneCount) {
+    snprintf(message, sizeof(message),
+             "; requested %d, placed %d (spacing too large for the shape)",
+             importOptions.droneCount, (int)layer.points.size());
+    importStatus += message;
+  }
+  std::cout << importStatus << std::endl;
+  return true;
+}
+
 void triggerTransition(int nextLayer) {
   if (droneShow.layers.empty() || nextLayer >= (int)droneShow.layers.size() ||
       currentLayer == nextLayer)
@@ -411,33 +732,688 @@ void spawnFireworks() {
 
   int numExplosions = std::min(15, (int)lastLayerPoints.size());
   for (int i = 0; i < numExplosions; ++i) {
-    const auto &drone = lastLayerPoints[rand() % lastLayerPoints.size()];
+    const auto &drone =
+        lastLayerPoints[simRng.below((uint32_t)lastLayerPoints.size())];
     Vec3 center = drone.pos;
-    Vec4 color = {(float)(rand() % 256) / 255.0f,
-                  (float)(rand() % 256) / 255.0f,
-                  (float)(rand() % 256) / 255.0f, 1.0f};
-    if (rand() % 5 == 0) { // Add some white fireworks
+    Vec4 color = {simRng.below(256) / 255.0f, simRng.below(256) / 255.0f,
+                  simRng.below(256) / 255.0f, 1.0f};
+    if (simRng.below(5) == 0) { // Add some white fireworks
       color = {1.0f, 1.0f, 1.0f, 1.0f};
     }
 
-    int numParticlesPerExplosion = 100 + (rand() % 50);
+    int numParticlesPerExplosion = 100 + simRng.below(50);
+    // Share the particle budget evenly between the explosions
+    numParticlesPerExplosion =
+        std::min(numParticlesPerExplosion, particleBudget / numExplosions);
     for (int j = 0; j < numParticlesPerExplosion; ++j) {
       Particle p;
       p.pos = center;
-      float speed = 100.0f + (rand() % 300);
-      float angle1 = (rand() / (float)RAND_MAX) * PI; // Hemisphere
-      float angle2 = (rand() / (float)RAND_MAX) * 3.0f * PI;
-      p.vel.x = speed * sin(angle1) * cos(angle2);
-      p.vel.y = speed * cos(angle1); // Y-up
-      p.vel.z = speed * sin(angle1) * sin(angle2);
+      float speed = 100.0f + simRng.below(300);
+      float angle1 = simRng.uniform() * PI; // Hemisphere
+      float angle2 = simRng.uniform() * 3.0f * PI;
+      p.vel.x = speed * std::sin(angle1) * std::cos(angle2);
+      p.vel.y = speed * std::cos(angle1); // Y-up
+      p.vel.z = speed * std::sin(angle1) * std::sin(angle2);
       p.color = color;
-      p.lifetime = 1.5f + (rand() / (float)RAND_MAX) * 2.0f;
+      p.lifetime = 1.5f + simRng.uniform() * 2.0f;
+      p.slot = (int)particles.size();
       particles.push_back(p);
     }
   }
 }
 
+void updateSimulation(float effectiveDeltaTime) {
+  if (initialAnimationState != DONE) {
+    switch (initialAnimationState) {
+    case PRE_TAKEOFF: {
+      preTakeoffTime += effectiveDeltaTime * 1000;
+      if (preTakeoffTime >= PRE_TAKEOFF_DURATION) {
+        initialAnimationState = TAKING_OFF;
+        transitionElapsedTime = 0.0f;
+      }
+      break;
+    }
+    case TAKING_OFF: {
+      transitionElapsedTime += effectiveDeltaTime * 1000;
+      float t = std::min(1.0f, transitionElapsedTime / transitionDuration);
+      float eased_t = easeOutCubic(t);
+
+      const auto &startPoints = groundFormation.points;
+      const auto &endPoints = droneShow.layers[0].points;
+
+      for (size_t i = 0; i < (size_t)maxDronesInShow; ++i) {
+        bool inEnd = i < endPoints.size();
+        Vec3 startPos = startPoints[i].pos;
+        Vec3 endPos = inEnd ? endPoints[i].pos : startPos;
+
+        animationBuffer[i].pos = naturalLerp(startPos, endPos, eased_t, i);
+        Vec4 startColor = startPoints[i].color;
+        Vec4 endColor = inEnd ? endPoints[i].color : Vec4{0, 0, 0, 0};
+        animationBuffer[i].color = lerp(startColor, endColor, eased_t);
+      }
+
+      if (t >= 1.0f) {
+        initialAnimationState = DONE;
+        const auto &finalPoints = droneShow.layers[0].points;
+        for (size_t i = 0; i < finalPoints.size(); ++i) {
+          animationBuffer[i] = finalPoints[i];
+        }
+        for (size_t i = finalPoints.size(); i < (size_t)maxDronesInShow;
+             ++i) {
+          animationBuffer[i].pos = {0, -200.0f, 0};
+          animationBuffer[i].color = {0, 0, 0, 0};
+        }
+        visibleDroneCount = finalPoints.size();
+        elapsedTime = 0.0f;
+        isPlaying = true;
+      }
+      break;
+    }
+    case DONE:
+      break;
+    }
+  } else if (isPlaying) {
+    elapsedTime += effectiveDeltaTime * 1000;
+    if (elapsedTime >= totalDuration && totalDuration > 0) {
+      if (enableFireworks) {
+        spawnFireworks();
+      }
+      elapsedTime = std::fmod(elapsedTime, totalDuration);
+      if (currentLayer != 0)
+        triggerTransition(0);
+    }
+
+    timelinePosition = totalDuration > 0 ? elapsedTime / totalDuration : 0;
+    float time_cursor = 0.0f;
+    for (size_t i = 0; i < droneShow.layers.size(); ++i) {
+      time_cursor += droneShow.layers[i].duration;
+      if (elapsedTime < time_cursor) {
+        if (currentLayer != (int)i && !inTransition)
+          triggerTransition((int)i);
+        break;
+      }
+    }
+  }
+
+  if (inTransition) {
+    transitionElapsedTime += effectiveDeltaTime * 1000;
+    float t = std::min(1.0f, transitionElapsedTime / transitionDuration);
+    float eased_t = easeOutCubic(t);
+    const auto &startPoints = droneShow.layers[previousLayer].points;
+    const auto &endPoints = droneShow.layers[currentLayer].points;
+
+    for (size_t i = 0; i < (size_t)maxDronesInShow; ++i) {
+      bool inStart = i < startPoints.size();
+      bool inEnd = i < endPoints.size();
+      Vec3 startPos, endPos;
+
+      if (inStart && inEnd) { // Exists in both, normal transition
+        startPos = startPoints[i].pos;
+        endPos = endPoints[i].pos;
+      } else if (inStart) { // Disappearing drone
+        startPos = startPoints[i].pos;
+        // Fly outwards to surroundings
+        Vec3 dir = {startPoints[i].pos.x, 0, startPoints[i].pos.z};
+        if (dot(dir, dir) < 0.1f)
+          dir = {std::sin((float)i), 0, std::cos((float)i)};
+        dir = normalize(dir);
+        endPos = dir * 500.0f;           // Fly far away
+        endPos.y = startPoints[i].pos.y; // Keep height
+
+      } else if (inEnd) { // Appearing drone
+        startPos = {endPoints[i].pos.x + std::sin((float)i) * 50.0f, -250.0f,
+                    endPoints[i].pos.z + std::cos((float)i) * 50.0f};
+        endPos = endPoints[i].pos;
+      } else { // Inactive drone
+        startPos = endPos = {0, -200.0f, 0};
+      }
+
+      animationBuffer[i].pos = naturalLerp(startPos, endPos, eased_t, i);
+
+      Vec4 startColor = inStart ? startPoints[i].color : Vec4{0, 0, 0, 0};
+      Vec4 endColor = inEnd ? endPoints[i].color : Vec4{0, 0, 0, 0};
+      animationBuffer[i].color = lerp(startColor, endColor, eased_t);
+    }
+
+    if (t >= 1.0f) {
+      inTransition = false;
+      const auto &finalPoints = droneShow.layers[currentLayer].points;
+      for (size_t i = 0; i < finalPoints.size(); ++i) {
+        animationBuffer[i] = finalPoints[i];
+      }
+      for (size_t i = finalPoints.size(); i < (size_t)maxDronesInShow; ++i) {
+        animationBuffer[i].pos = {0, -200.0f, 0};
+        animationBuffer[i].color = {0, 0, 0, 0};
+      }
+      visibleDroneCount = finalPoints.size();
+    }
+  }
+
+  // Update and manage particles
+  bool hadParticles = !particles.empty();
+  if ((int)particles.size() > particleBudget)
+    particles.resize(particleBudget);
+  if (!particles.empty()) {
+    float gravity = 20.0f;
+    for (auto it = particles.begin(); it != particles.end();) {
+      it->pos = it->pos + it->vel * effectiveDeltaTime;
+      it->vel.y -= gravity * effectiveDeltaTime;
+      it->lifetime -= effectiveDeltaTime;
+      if (it->lifetime <= 0) {
+        it = particles.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  
+  if (hadParticles && particles.empty() && enableFireworks &&
+      !groundFormation.points.empty()) {
+    resetToGround();
+  }
+}
+
+// --- Simulation Thread ---
+double clockSeconds() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void postSimCommand(SimCommandType type, float value) {
+  std::lock_guard<std::mutex> lock(simCommandMutex);
+  simCommands.push_back({type, value});
+}
+
+// Applies the commands posted since the last call, in order. Returns false
+// if there were none.
+bool applySimCommands() {
+  {
+    std::lock_guard<std::mutex> lock(simCommandMutex);
+    simCommandsInFlight.swap(simCommands);
+  }
+  for (const SimCommand &command : simCommandsInFlight) {
+    switch (command.type) {
+    case SIM_SET_PLAYING:
+      isPlaying = command.value != 0.0f;
+      break;
+    case SIM_SEEK:
+      if (bakedShow.isOpen()) {
+        seekBaked((int)std::lround(command.value *
+                                   (bakedShow.frameCount() - 1)));
+        break;
+      }
+      timelinePosition = command.value;
+      elapsedTime = timelinePosition * totalDuration;
+      break;
+    case SIM_SET_SPEED:
+      playbackSpeed = command.value;
+      break;
+    case SIM_TRANSITION_TO:
+      if (bakedShow.isOpen()) {
+        int frame = bakedShow.firstFrameOfLayer((int)command.value);
+        if (frame >= 0)
+          seekBaked(frame);
+        break;
+      }
+      triggerTransition((int)command.value);
+      break;
+    case SIM_SET_VISIBLE_DRONES:
+      visibleDroneCount = (int)command.value;
+      break;
+    case SIM_SET_FIREWORKS:
+      enableFireworks = command.value != 0.0f;
+      break;
+    case SIM_SET_PARTICLE_BUDGET:
+      particleBudget = (int)command.value;
+      break;
+    }
+  }
+  bool applied = !simCommandsInFlight.empty();
+  simCommandsInFlight.clear();
+  return applied;
+}
+
+// One tick of baked playback: the next frame while playing, wrapping to the
+// loop frame after the last one.
+void stepBaked() {
+  if (isPlaying) {
+    if (++bakedFrame >= bakedShow.frameCount()) {
+      bakedFrame = bakedShow.header.loopFrame;
+      ++simGeneration;
+    }
+  } else if (!bakedFrameDirty) {
+    return;
+  }
+  bakedFrameDirty = false;
+  showBakedFrame();
+}
+
+// Runs as many fixed ticks as `seconds` of real time cover at the current
+// playback speed. The remainder is carried over in `accumulator`.
+int advanceSimulation(double seconds, double &accumulator) {
+  accumulator = std::min(accumulator + seconds * playbackSpeed,
+                         SIM_MAX_CATCH_UP_TICKS * SIM_DT);
+  int ticks = 0;
+  for (; accumulator >= SIM_DT; accumulator -= SIM_DT, ++ticks) {
+    if (bakedShow.isOpen())
+      stepBaked();
+    else
+      updateSimulation((float)SIM_DT);
+  }
+  return ticks;
+}
+
+void publishSnapshot(double time, float tickMs) {
+  SimSnapshot &snapshot = simSnapshots.writeBuffer();
+  size_t visible = visibleDroneCount < 0
+                       ? animationBuffer.size()
+                       : std::min((size_t)visibleDroneCount,
+                                  animationBuffer.size());
+  snapshot.drones.assign(animationBuffer.begin(),
+                         animationBuffer.begin() + visible);
+  // Match the particle capacity up front so each snapshot buffer grows once
+  snapshot.particles.reserve(particles.capacity());
+  snapshot.particles.assign(particles.begin(), particles.end());
+  snapshot.currentLayer = currentLayer;
+  snapshot.visibleDroneCount = (int)visible;
+  snapshot.isPlaying = isPlaying;
+  snapshot.enableFireworks = enableFireworks;
+  snapshot.timelinePosition = timelinePosition;
+  snapshot.playbackSpeed = playbackSpeed;
+  snapshot.time = time;
+  snapshot.generation = simGeneration;
+  snapshot.tickMs = tickMs;
+  simSnapshots.publish();
+}
+
+void simulationLoop() {
+  double accumulator = 0.0, lastTime = clockSeconds(), tickTime = lastTime;
+  float tickMs = 0.0f;
+  while (simRunning.load(std::memory_order_relaxed)) {
+    double now = clockSeconds();
+    bool changed = applySimCommands();
+    int ticks = advanceSimulation(now - lastTime, accumulator);
+    lastTime = now;
+    if (ticks > 0) {
+      tickMs = (clockSeconds() - now) * 1000.0 / ticks;
+      // The moment the newest tick was due, so the render thread can
+      // place frames between ticks
+      tickTime = now - accumulator / std::max(playbackSpeed, 0.01f);
+    }
+    if (ticks > 0 || changed)
+      publishSnapshot(tickTime, tickMs);
+    // Wake up for the next tick, or sooner to stay responsive to commands
+    // at slow playback speeds
+    double wait = std::min(
+        SIM_DT, (SIM_DT - accumulator) / std::max(playbackSpeed, 0.01f));
+    std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+  }
+}
+
+void startSimulation() {
+  if (simRunning)
+    return;
+  applySimCommands();
+  publishSnapshot(clockSeconds(), 0.0f);
+  simRunning = true;
+  simThread = std::thread(simulationLoop);
+}
+
+// Returns whether the thread was running.
+bool stopSimulation() {
+  if (!simRunning)
+    return false;
+  simRunning = false;
+  simThread.join();
+  return true;
+}
+
+// Takes the newest snapshot and keeps the one before it for interpolation.
+// The swaps hand the oldest buffer back to the simulation without copying.
+void acquireSnapshot() {
+  if (!simSnapshots.update())
+    return;
+  std::swap(previousSnapshot, currentSnapshot);
+  std::swap(currentSnapshot, simSnapshots.readBuffer());
+}
+
+// How far `now` is between the two newest ticks. Frames trail the
+// simulation by up to one tick in exchange for smooth motion.
+float snapshotAlpha(double now) {
+  double span = currentSnapshot.time - previousSnapshot.time;
+  if (span <= 0.0)
+    return 1.0f;
+  return (float)std::min(std::max((now - currentSnapshot.time) / span, 0.0),
+                         1.0);
+}
+
+// Blends the two newest snapshots into renderDrones and renderParticles.
+void interpolateSnapshot(float alpha) {
+  const SimSnapshot &from = previousSnapshot, &to = currentSnapshot;
+  if (from.generation != to.generation)
+    alpha = 1.0f;
+  size_t blended =
+      alpha < 1.0f ? std::min(from.drones.size(), to.drones.size()) : 0;
+  renderDrones.resize(to.drones.size());
+  for (size_t i = 0; i < blended; ++i) {
+    renderDrones[i].pos = lerp(from.drones[i].pos, to.drones[i].pos, alpha);
+    renderDrones[i].color =
+        lerp(from.drones[i].color, to.drones[i].color, alpha);
+  }
+  std::copy(to.drones.begin() + blended, to.drones.end(),
+            renderDrones.begin() + blended);
+
+  // Particles are erased when they die, so indices do not match between
+  // ticks; move them back along their velocity instead.
+  float rewind = (alpha - 1.0f) * (float)SIM_DT;
+  renderParticles.reserve(to.particles.capacity());
+  renderParticles.resize(to.particles.size());
+  for (size_t i = 0; i < to.particles.size(); ++i) {
+    renderParticles[i] = to.particles[i];
+    renderParticles[i].pos = to.particles[i].pos + to.particles[i].vel * rewind;
+  }
+}
+
+void computeCamera(const ViewCamera &camera, float aspect, Mat4 &view,
+                   Mat4 &projection) {
+  Vec3 camPos;
+  const Vec3 &target = camera.target;
+  float orthoSize = camera.orthoSize;
+
+  switch (camera.mode) {
+  case VIEW_3D:
+    camPos.x = target.x +
+               camera.radius * std::cos(camera.pitch) * std::cos(camera.yaw);
+    camPos.y = target.y + camera.radius * std::sin(camera.pitch);
+    camPos.z = target.z +
+               camera.radius * std::cos(camera.pitch) * std::sin(camera.yaw);
+    projection = perspective(45.0f, aspect, 0.1f, 5000.0f);
+    view = lookAt(camPos, target, {0, 1, 0});
+    break;
+  case VIEW_2D_TOP:
+    projection = orthographic(-orthoSize * aspect, orthoSize * aspect,
+                              -orthoSize, orthoSize, -1000.0f, 1000.0f);
+    view = lookAt({target.x, 500, target.z}, target, {0, 0, -1});
+    break;
+  case VIEW_2D_FRONT:
+    projection = orthographic(-orthoSize * aspect, orthoSize * aspect,
+                              -orthoSize, orthoSize, -1000.0f, 5000.0f);
+    view = lookAt({target.x, target.y, 500}, target, {0, 1, 0});
+    break;
+  }
+}
+
+void initSplitCameras() {
+  splitCameras[0].pitch = 0.3f;
+  splitCameras[1].mode = VIEW_2D_TOP;
+  splitCameras[2].mode = VIEW_2D_FRONT;
+  for (int i = 3; i < MAX_VIEWS; ++i) {
+    splitCameras[i].yaw = -PI / 2.0f + (i - 2) * (2.0f * PI / 6.0f);
+    splitCameras[i].pitch = 0.4f;
+    splitCameras[i].radius = 700.0f;
+  }
+}
+
+// Splits a width x height render target into one pane per active camera and
+// computes their matrices and uniform blocks. Rows hold the same number of
+// panes, the top rows one fewer when they do not divide evenly.
+void layoutViews(int width, int height) {
+  static const char *SPLIT_LABELS[MAX_VIEWS] = {
+      "3D", "Top", "Front", "Orbit 1", "Orbit 2", "Orbit 3", "Orbit 4",
+      "Orbit 5"};
+  int count = splitScreen ? splitViewCount : 1;
+  int rows = (int)std::round(std::sqrt((float)count));
+  viewPanes.resize(count);
+  int pane = 0;
+  for (int row = 0; row < rows; ++row) {
+    int inRow = count / rows + (row >= rows - count % rows ? 1 : 0);
+    for (int col = 0; col < inRow; ++col, ++pane) {
+      ViewPane &p = viewPanes[pane];
+      p.camera = splitScreen ? &splitCameras[pane] : &mainCamera;
+      p.label = splitScreen ? SPLIT_LABELS[pane] : "";
+      p.x = (float)col / inRow;
+      p.y = (float)row / rows;
+      p.w = 1.0f / inRow;
+      p.h = 1.0f / rows;
+      int x0 = (int)std::lround(p.x * width);
+      int x1 = (int)std::lround((p.x + p.w) * width);
+      int y0 = height - (int)std::lround((p.y + p.h) * height);
+      int y1 = height - (int)std::lround(p.y * height);
+      // Leave a one pixel gap between panes
+      int gap = splitScreen ? 1 : 0;
+      p.pixelX = x0 + (x0 > 0 ? gap : 0);
+      p.pixelY = y0 + (y0 > 0 ? gap : 0);
+      p.pixelW = std::max(1, x1 - p.pixelX);
+      p.pixelH = std::max(1, y1 - p.pixelY);
+      computeCamera(*p.camera, (float)p.pixelW / p.pixelH, p.view,
+                    p.projection);
+    }
+  }
+
+  const QualitySettings &quality = governor.settings();
+  viewUniformData.resize(count * viewUniformStride);
+  for (int i = 0; i < count; ++i) {
+    const ViewPane &p = viewPanes[i];
+    ViewUniforms uniforms;
+    Vec3 right = viewRight(p.view), up = viewUp(p.view);
+    uniforms.viewProjection = multiply(p.projection, p.view);
+    uniforms.cameraRight = {right.x, right.y, right.z, 0.0f};
+    uniforms.cameraUp = {up.x, up.y, up.z, 0.0f};
+    uniforms.cull = {(float)p.pixelH, quality.cullPixelSize, 0.0f, 0.0f};
+    memcpy(&viewUniformData[i * viewUniformStride], &uniforms,
+           sizeof(uniforms));
+  }
+}
+
+// Pane under a window position given as a fraction of the window size.
+ViewPane *paneAt(float x, float y) {
+  for (ViewPane &pane : viewPanes) {
+    if (x >= pane.x && x < pane.x + pane.w && y >= pane.y &&
+        y < pane.y + pane.h)
+      return &pane;
+  }
+  return viewPanes.empty() ? nullptr : &viewPanes[0];
+}
+
+// Fills vertexData with the interpolated drones and particles. With a single
+// pane, drones outside its view are skipped here; with several panes
+// everything is uploaded once and the geometry shader culls per view.
+void buildVertexData() {
+  const QualitySettings &quality = governor.settings();
+  const ViewPane *cullPane = viewPanes.size() == 1 ? &viewPanes[0] : nullptr;
+  // Skip drones outside the view and, depending on the governor level,
+  // drones whose sprite covers less than a few pixels on screen.
+  Mat4 viewProjection, projection;
+  if (cullPane) {
+    projection = cullPane->projection;
+    viewProjection = multiply(projection, cullPane->view);
+  }
+  float clipRadius = droneSize * std::max(projection.m[0], projection.m[5]);
+  // Sprite diameter in pixels for a drone at clip w = 1
+  float spritePixels =
+      droneSize * projection.m[5] * (cullPane ? cullPane->pixelH : 0);
+  auto isVisible = [&](const Vec4 &clip) {
+    if (clip.w <= 0.0f || clip.x > clip.w + clipRadius ||
+        clip.x < -clip.w - clipRadius || clip.y > clip.w + clipRadius ||
+        clip.y < -clip.w - clipRadius)
+      return false;
+    return spritePixels >= quality.cullPixelSize * clip.w;
+  };
+
+  int numDronesToRender = renderDrones.size();
+  vertexData.clear();
+  vertexData.reserve(
+      (numDronesToRender +
+       std::max((int)renderParticles.size(), MAX_FIREWORK_PARTICLES)) *
+      7);
+  if (cullPane) {
+    clipPositions.resize(numDronesToRender);
+    if (numDronesToRender > 0)
+      transformPoints(viewProjection, &renderDrones[0].pos,
+                      sizeof(DronePoint), numDronesToRender,
+                      clipPositions.data());
+  }
+  dronesCulled = 0;
+  for (int i = 0; i < numDronesToRender; ++i) {
+    const auto &p = renderDrones[i];
+    if (cullPane && !isVisible(clipPositions[i])) {
+      ++dronesCulled;
+      continue;
+    }
+    vertexData.push_back(p.pos.x);
+    vertexData.push_back(p.pos.y);
+    vertexData.push_back(p.pos.z);
+    vertexData.push_back(p.color.x);
+    vertexData.push_back(p.color.y);
+    vertexData.push_back(p.color.z);
+    vertexData.push_back(p.color.w);
+  }
+
+  // Add particles to vertex data
+  for (const auto &p : renderParticles) {
+    vertexData.push_back(p.pos.x);
+    vertexData.push_back(p.pos.y);
+    vertexData.push_back(p.pos.z);
+    vertexData.push_back(p.color.x);
+    vertexData.push_back(p.color.y);
+    vertexData.push_back(p.color.z);
+    vertexData.push_back(p.color.w);
+  }
+}
+
+uint32_t packColor(const Vec4 &color) {
+  auto channel = [](float v) {
+    return (uint32_t)(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f);
+  };
+  return channel(color.x) | channel(color.y) << 8 | channel(color.z) << 16 |
+         channel(color.w) << 24;
+}
+
+// Fills this frame's trail row from the interpolated drones and particles.
+// Slots without a drone or live particle get alpha 0, which ends their
+// trail.
+void buildTrailRow() {
+  size_t fleet = std::max((size_t)maxDronesInShow, renderDrones.size());
+  size_t slots = fleet + MAX_FIREWORK_PARTICLES;
+  trailPositions.assign(slots, Vec4{0, 0, 0, 0});
+  trailColors.assign(slots, 0);
+  for (size_t i = 0; i < renderDrones.size(); ++i) {
+    const DronePoint &p = renderDrones[i];
+    trailPositions[i] = {p.pos.x, p.pos.y, p.pos.z, p.color.w};
+    trailColors[i] = packColor(p.color);
+  }
+  for (const Particle &p : renderParticles) {
+    size_t slot = fleet + p.slot;
+    if (slot >= slots)
+      continue;
+    trailPositions[slot] = {p.pos.x, p.pos.y, p.pos.z, p.color.w};
+    trailColors[slot] = packColor(p.color);
+  }
+}
+
+// Minimal file browser for picking an image to import as a layer.
+void renderImportDialog() {
+  ImGui::SetNextWindowSize(ImVec2(480, 460), ImGuiCond_Appearing);
+  if (!ImGui::BeginPopupModal("Import Image"))
+    return;
+
+  namespace fs = std::filesystem;
+  if (importBrowseDirty) {
+    importBrowseDirty = false;
+    importBrowseEntries.clear();
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator(importBrowseDir, ec)) {
+      std::string name = entry.path().filename().string();
+      std::string ext = entry.path().extension().string();
+      std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+      bool isDir = entry.is_directory(ec);
+      if (isDir || ext == ".png" || ext == ".jpg" || ext == ".jpeg")
+        importBrowseEntries.push_back({name, isDir});
+    }
+    std::sort(importBrowseEntries.begin(), importBrowseEntries.end(),
+              [](const std::pair<std::string, bool> &a,
+                 const std::pair<std::string, bool> &b) {
+                return a.second != b.second ? a.second : a.first < b.first;
+              });
+  }
+
+  ImGui::Text("%s", importBrowseDir.c_str());
+  ImGui::BeginChild("##files", ImVec2(0, 200), ImGuiChildFlags_Borders);
+  if (ImGui::Selectable("[..]")) {
+    importBrowseDir = (fs::path(importBrowseDir) / "..").lexically_normal()
+                          .string();
+    importBrowseDirty = true;
+  }
+  for (const auto &entry : importBrowseEntries) {
+    std::string label = entry.second ? "[" + entry.first + "]" : entry.first;
+    if (ImGui::Selectable(label.c_str())) {
+      fs::path full = fs::path(importBrowseDir) / entry.first;
+      if (entry.second) {
+        importBrowseDir = full.lexically_normal().string();
+        importBrowseDirty = true;
+      } else {
+        snprintf(importPath, sizeof(importPath), "%s",
+                 full.string().c_str());
+      }
+    }
+  }
+  ImGui::EndChild();
+
+  ImGui::InputText("Path", importPath, sizeof(importPath));
+  ImGui::InputInt("Drones", &importOptions.droneCount, 1000, 10000);
+  importOptions.droneCount =
+      std::min(std::max(importOptions.droneCount, 1), IMPORT_MAX_DRONES);
+  if (importOptions.droneCount == IMPORT_MAX_DRONES)
+    ImGui::TextWrapped("Limited to %d drones per image", IMPORT_MAX_DRONES);
+  ImGui::DragFloat("Min Spacing", &importOptions.minSeparation, 0.1f, 0.0f,
+                   100.0f, importOptions.minSeparation > 0 ? "%.1f" : "auto");
+  ImGui::DragFloat("Max Size", &importOptions.maxSize, 5.0f, 10.0f, 5000.0f);
+  ImGui::InputInt("Duration (ms)", &importOptions.duration, 500, 1000);
+  importOptions.duration = std::max(importOptions.duration, 100);
+
+  if (ImGui::Button("Import") && importPath[0]) {
+    if (importImage(importPath))
+      ImGui::CloseCurrentPopup();
+  }
+  ImGui::SameLine();
+  if (ImGui::Button("Close"))
+    ImGui::CloseCurrentPopup();
+  if (!importStatus.empty())
+    ImGui::TextWrapped("%s", importStatus.c_str());
+  ImGui::EndPopup();
+}
+
+// Draws a layer's atlas tile, or a blank square until it has been rendered.
+void drawLayerThumbnail(size_t layer, float size) {
+  if (thumbnails.ready(layer)) {
+    float u0, v0, u1, v1;
+    thumbnails.tileUV(layer, u0, v0, u1, v1);
+    ImGui::Image((ImTextureID)(intptr_t)thumbnails.texture(),
+                 ImVec2(size, size), ImVec2(u0, v0), ImVec2(u1, v1));
+  } else {
+    ImGui::Dummy(ImVec2(size, size));
+    ImGui::GetWindowDrawList()->AddRectFilled(
+        ImGui::GetItemRectMin(), ImGui::GetItemRectMax(),
+        IM_COL32(40, 40, 48, 255));
+  }
+}
+
+void layerTooltip(size_t layer) {
+  const DroneLayer &l = droneShow.layers[layer];
+  ImGui::BeginTooltip();
+  drawLayerThumbnail(layer, THUMBNAIL_SIZE * 2.0f);
+  ImGui::Text("%d. %s", (int)layer + 1, l.name.c_str());
+  if (!l.points.empty())
+    ImGui::Text("%d drones, %.1f s", (int)l.points.size(),
+                l.duration / 1000.0f);
+  ImGui::EndTooltip();
+}
+
+// The UI shows the newest simulation snapshot and sends changes back as
+// commands, since the simulation thread owns the show state.
 void renderUI() {
+  const SimSnapshot &sim = currentSnapshot;
   ImGui::SetNextWindowPos(ImVec2(0, 0));
   ImGui::SetNextWindowSize(ImVec2(ImGui::GetIO().DisplaySize.x, 50));
   ImGui::Begin("Header", NULL,
@@ -445,53 +1421,105 @@ void renderUI() {
   ImGui::Text("%s", droneShow.title.c_str());
   ImGui::End();
 
-  ImGui::SetNextWindowPos(ImVec2(0, ImGui::GetIO().DisplaySize.y - 80));
-  ImGui::SetNextWindowSize(ImVec2(ImGui::GetIO().DisplaySize.x, 80));
+  // Thumbnail strip above the timeline, one tile per layer
+  const float STRIP_TILE = 44.0f;
+  float stripHeight = STRIP_TILE + ImGui::GetStyle().ScrollbarSize + 8.0f;
+  float controlsHeight = 80.0f + stripHeight;
+  ImGui::SetNextWindowPos(
+      ImVec2(0, ImGui::GetIO().DisplaySize.y - controlsHeight));
+  ImGui::SetNextWindowSize(
+      ImVec2(ImGui::GetIO().DisplaySize.x, controlsHeight));
   ImGui::Begin("Controls", NULL,
                ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove);
-  if (ImGui::Button(isPlaying ? "Pause" : "Play")) {
-    isPlaying = !isPlaying;
+  ImGui::BeginChild("##thumbnails", ImVec2(0, stripHeight),
+                    ImGuiChildFlags_None,
+                    ImGuiWindowFlags_HorizontalScrollbar);
+  for (size_t i = 0; i < droneShow.layers.size(); ++i) {
+    if (i > 0)
+      ImGui::SameLine(0.0f, 4.0f);
+    drawLayerThumbnail(i, STRIP_TILE);
+    if (ImGui::IsItemHovered())
+      layerTooltip(i);
+    if (ImGui::IsItemClicked() && sim.currentLayer != (int)i)
+      postSimCommand(SIM_TRANSITION_TO, (float)i);
+    if (sim.currentLayer == (int)i) {
+      ImGui::GetWindowDrawList()->AddRect(ImGui::GetItemRectMin(),
+                                          ImGui::GetItemRectMax(),
+                                          IM_COL32(255, 200, 60, 255), 0.0f,
+                                          0, 2.0f);
+      // Keep the current layer in view as the show advances
+      if (thumbnailStripLayer != sim.currentLayer) {
+        ImGui::SetScrollHereX(0.5f);
+        thumbnailStripLayer = sim.currentLayer;
+      }
+    }
+  }
+  ImGui::EndChild();
+  if (ImGui::Button(sim.isPlaying ? "Pause" : "Play")) {
+    postSimCommand(SIM_SET_PLAYING, !sim.isPlaying);
   }
   ImGui::SameLine();
   ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - 250);
-  if (ImGui::SliderFloat("##timeline", &timelinePosition, 0.0f, 1.0f)) {
-    elapsedTime = timelinePosition * totalDuration;
+  float timeline = sim.timelinePosition;
+  if (ImGui::SliderFloat("##timeline", &timeline, 0.0f, 1.0f)) {
+    postSimCommand(SIM_SEEK, timeline);
   }
   ImGui::SameLine();
   ImGui::SetNextItemWidth(120);
-  ImGui::SliderFloat("Speed", &playbackSpeed, 0.1f, 4.0f, "%.1fx");
+  float speed = sim.playbackSpeed;
+  if (ImGui::SliderFloat("Speed", &speed, 0.1f, 4.0f, "%.1fx"))
+    postSimCommand(SIM_SET_SPEED, speed);
   ImGui::End();
 
   ImGui::SetNextWindowPos(ImVec2(10, 60));
-  ImGui::SetNextWindowSize(ImVec2(250, 350));
+  ImGui::SetNextWindowSize(ImVec2(250, 450));
   ImGui::Begin("Info & Settings");
-  ImGui::Text("Layer: %s", droneShow.layers.empty()
-                               ? "N/A"
-                               : droneShow.layers[currentLayer].name.c_str());
-  ImGui::Text("Drones: %d", visibleDroneCount == -1
-                                ? (int)animationBuffer.size()
-                                : visibleDroneCount);
+  bool layerKnown =
+      sim.currentLayer >= 0 && sim.currentLayer < (int)droneShow.layers.size();
+  ImGui::Text("Layer: %s",
+              layerKnown ? droneShow.layers[sim.currentLayer].name.c_str()
+                         : "N/A");
+  ImGui::Text("Drones: %d", sim.visibleDroneCount);
   if (!droneShow.layers.empty()) {
-    if (ImGui::SliderInt("Drone Count", &visibleDroneCount, 1,
-                         maxDronesInShow)) {
-      // Value changed
+    int droneCount = sim.visibleDroneCount;
+    if (ImGui::SliderInt("Drone Count", &droneCount, 1, maxDronesInShow)) {
+      postSimCommand(SIM_SET_VISIBLE_DRONES, droneCount);
     }
   }
   ImGui::SliderFloat("Drone Size", &droneSize, 0.1f, 20.0f);
   ImGui::Separator();
-  ImGui::Checkbox("Enable Fireworks on Finish", &enableFireworks);
+  bool fireworks = sim.enableFireworks;
+  if (ImGui::Checkbox("Enable Fireworks on Finish", &fireworks))
+    postSimCommand(SIM_SET_FIREWORKS, fireworks);
+  if (ImGui::Checkbox("Motion Trails", &enableTrails))
+    trailStatus.clear();
+  if (!trailStatus.empty())
+    ImGui::TextWrapped("%s", trailStatus.c_str());
+  if (enableTrails) {
+    ImGui::SliderInt("Trail Length", &trails.length, 2, 64);
+    if (trails.keptLength() > 0 && trails.keptLength() < trails.length)
+      ImGui::TextWrapped("Memory budget keeps %d samples",
+                         trails.keptLength());
+    ImGui::SliderInt("Trail Spacing", &trails.spacing, 1, 8, "%d frames");
+    ImGui::SliderFloat("Trail Fade", &trails.fade, 0.2f, 4.0f, "%.1f");
+  }
   ImGui::Separator();
   ImGui::Text("View Mode");
-  if (ImGui::RadioButton("3D", currentViewMode == VIEW_3D)) {
-    currentViewMode = VIEW_3D;
-  }
-  ImGui::SameLine();
-  if (ImGui::RadioButton("2D Top", currentViewMode == VIEW_2D_TOP)) {
-    currentViewMode = VIEW_2D_TOP;
-  }
-  ImGui::SameLine();
-  if (ImGui::RadioButton("2D Front", currentViewMode == VIEW_2D_FRONT)) {
-    currentViewMode = VIEW_2D_FRONT;
+  ImGui::Checkbox("Split Screen", &splitScreen);
+  if (!splitScreen) {
+    if (ImGui::RadioButton("3D", mainCamera.mode == VIEW_3D)) {
+      mainCamera.mode = VIEW_3D;
+    }
+    ImGui::SameLine();
+    if (ImGui::RadioButton("2D Top", mainCamera.mode == VIEW_2D_TOP)) {
+      mainCamera.mode = VIEW_2D_TOP;
+    }
+    ImGui::SameLine();
+    if (ImGui::RadioButton("2D Front", mainCamera.mode == VIEW_2D_FRONT)) {
+      mainCamera.mode = VIEW_2D_FRONT;
+    }
+  } else {
+    ImGui::SliderInt("Views", &splitViewCount, 2, MAX_VIEWS);
   }
   ImGui::Separator();
   ImGui::Text("Mouse Controls:");
@@ -499,20 +1527,495 @@ void renderUI() {
   ImGui::Text("Scroll to Zoom");
   ImGui::End();
 
+  ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x - 260, 270),
+                          ImGuiCond_FirstUseEver);
+  ImGui::SetNextWindowSize(ImVec2(250, 300), ImGuiCond_FirstUseEver);
+  ImGui::Begin("Performance");
+  const QualitySettings &quality = governor.settings();
+  ImGui::Text("CPU update: %.2f ms", governor.cpuMs);
+  ImGui::Text("GPU frame:  %.2f ms", governor.gpuMs);
+  ImGui::Text("Sim tick:   %.2f ms @ %.0f Hz", sim.tickMs, 1.0 / SIM_DT);
+  ImGui::Checkbox("Adaptive Quality", &governor.enabled);
+  ImGui::SliderFloat("Target (ms)", &governor.targetFrameMs, 4.0f, 50.0f,
+                     "%.1f");
+  if (!governor.enabled)
+    ImGui::SliderInt("Level", &governor.level, 0,
+                     QualityGovernor::levelCount() - 1);
+  else
+    ImGui::Text("Level: %d / %d", governor.level,
+                QualityGovernor::levelCount() - 1);
+  ImGui::Text("%s", governor.lastDecision);
+  ImGui::Separator();
+  ImGui::Text("Particles: %d / %d", (int)sim.particles.size(),
+              quality.particleBudget);
+  if (viewPanes.size() > 1)
+    ImGui::Text("Culled drones: per view (< %.1f px)",
+                quality.cullPixelSize);
+  else
+    ImGui::Text("Culled drones: %d (< %.1f px)", dronesCulled,
+                quality.cullPixelSize);
+  ImGui::Text("Mip bias: %.1f", quality.mipBias);
+  ImGui::Text("Render scale: %d%%", (int)(quality.renderScale * 100.0f));
+  if (enableTrails)
+    ImGui::Text("Trail ring: %.1f MB", trails.ringBytes() / 1048576.0);
+  ImGui::Text("Thumbnails: %d pending, %.1f MB atlas",
+              thumbnails.pendingTiles(), thumbnails.atlasBytes() / 1048576.0);
+  ImGui::Separator();
+  ImGui::Text("Show arena: %.1f / %.1f MB", showArena.usedBytes() / 1048576.0,
+              showArena.capacity() / 1048576.0);
+  if (allocTrackingEnabled()) {
+    AllocStats heap = allocStats();
+    ImGui::Text("Heap: %.1f MB live, %.1f MB peak",
+                heap.liveBytes / 1048576.0, heap.peakBytes / 1048576.0);
+    ImGui::Text("Allocations: %llu total, %llu last frame",
+                (unsigned long long)heap.allocations,
+                (unsigned long long)lastFrameAllocations);
+  } else {
+    ImGui::TextDisabled("Heap tracking: make TRACK_ALLOCS=1");
+  }
+  ImGui::End();
+
   ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x - 260, 60));
   ImGui::SetNextWindowSize(ImVec2(250, 200));
   ImGui::Begin("Layers");
   for (size_t i = 0; i < droneShow.layers.size(); ++i) {
     if (ImGui::Selectable(droneShow.layers[i].name.c_str(),
-                          currentLayer == (int)i)) {
-      if (currentLayer != (int)i)
-        triggerTransition((int)i);
+                          sim.currentLayer == (int)i)) {
+      if (sim.currentLayer != (int)i)
+        postSimCommand(SIM_TRANSITION_TO, (float)i);
     }
+    if (ImGui::IsItemHovered())
+      layerTooltip(i);
+  }
+  ImGui::Separator();
+  if (ImGui::Button("Import Image...")) {
+    importBrowseDirty = true;
+    ImGui::OpenPopup("Import Image");
   }
+  renderImportDialog();
   ImGui::End();
+
+  // Name each split-screen pane below the header bar
+  ImDrawList *drawList = ImGui::GetBackgroundDrawList();
+  ImVec2 display = ImGui::GetIO().DisplaySize;
+  for (const ViewPane &pane : viewPanes) {
+    if (!pane.label[0])
+      continue;
+    float top = std::max(pane.y * display.y, 50.0f);
+    float center = (pane.x + pane.w * 0.5f) * display.x;
+    drawList->AddText(
+        ImVec2(center - ImGui::CalcTextSize(pane.label).x * 0.5f, top + 6.0f),
+        IM_COL32(255, 255, 255, 160), pane.label);
+  }
+}
+
+// --- Headless Benchmark ---
+size_t peakResidentSetBytes() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return counters.PeakWorkingSetSize;
+  return 0;
+#else
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss; // Bytes on macOS
+#else
+  return (size_t)usage.ru_maxrss * 1024; // Kilobytes on Linux
+#endif
+#endif
 }
 
-int main() {
+// Loads a show (plus any --import images) without opening a window, plays it
+// from the ground formation in 60 Hz frames and then seeks to pseudo-random
+// timeline positions the way the timeline slider does. Frames run the same
+// fixed ticks, snapshot and interpolation as the simulation thread, just
+// inline. Prints load time, peak RSS, the per-frame update time (simulation
+// + vertex build) and a hash of the final drone state as one key=value line;
+// the hash is the same on every run with the same seed.
+int runBenchmark(const char *path, int frames, int seeks,
+                 const std::vector<const char *> &imagePaths) {
+  typedef std::chrono::steady_clock Clock;
+  auto msSince = [](Clock::time_point t) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t)
+        .count();
+  };
+  const float FRAME_DT = 1.0f / 60.0f;
+  const int FRAMES_PER_SEEK = 90; // Long enough to finish a transition
+  const int VIEWPORT_W = 1280, VIEWPORT_H = 720;
+
+  const int WARMUP_FRAMES = 60; // Buffers reach their working size
+
+  uint64_t loadAllocations = allocStats().allocations;
+  Clock::time_point loadStart = Clock::now();
+  loadDroneShow(path);
+  for (const char *image : imagePaths)
+    importImage(image);
+  double loadMs = msSince(loadStart);
+  loadAllocations = allocStats().allocations - loadAllocations;
+  if (droneShow.layers.empty())
+    return 1;
+
+  std::vector<double> frameMs;
+  frameMs.reserve(frames + seeks * FRAMES_PER_SEEK);
+  uint64_t frameAllocations = 0, steadyAllocations = 0;
+  int steadyFramesAllocating = 0;
+  double accumulator = 0.0;
+  auto step = [&]() {
+    uint64_t allocationsBefore = allocStats().allocations;
+    Clock::time_point frameStart = Clock::now();
+    bool changed = applySimCommands();
+    if (advanceSimulation(FRAME_DT, accumulator) > 0 || changed)
+      publishSnapshot(0.0, 0.0f);
+    acquireSnapshot();
+    interpolateSnapshot((float)(accumulator / SIM_DT));
+    layoutViews(VIEWPORT_W, VIEWPORT_H);
+    buildVertexData();
+    if (enableTrails)
+      buildTrailRow();
+    frameMs.push_back(msSince(frameStart));
+    uint64_t allocated = allocStats().allocations - allocationsBefore;
+    frameAllocations += allocated;
+    if (frameMs.size() > (size_t)WARMUP_FRAMES) {
+      steadyAllocations += allocated;
+      steadyFramesAllocating += allocated > 0;
+    }
+  };
+
+  for (int i = 0; i < frames; ++i)
+    step();
+  unsigned int seekSeed = 12345;
+  for (int i = 0; i < seeks; ++i) {
+    seekSeed = seekSeed * 1664525u + 1013904223u;
+    postSimCommand(SIM_SEEK, (seekSeed >> 8) / 16777216.0f);
+    for (int j = 0; j < FRAMES_PER_SEEK; ++j)
+      step();
+  }
+
+  std::vector<double> sorted = frameMs;
+  std::sort(sorted.begin(), sorted.end());
+  double sum = 0.0;
+  for (double ms : sorted)
+    sum += ms;
+  size_t count = sorted.size();
+
+  // FNV-1a over the simulated positions and colors
+  uint64_t stateHash = 14695981039346656037ull;
+  auto hashFloat = [&](float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    stateHash = (stateHash ^ bits) * 1099511628211ull;
+  };
+  for (const auto &p : animationBuffer) {
+    hashFloat(p.pos.x);
+    hashFloat(p.pos.y);
+    hashFloat(p.pos.z);
+    hashFloat(p.color.w);
+  }
+  for (const auto &p : particles) {
+    hashFloat(p.pos.x);
+    hashFloat(p.pos.y);
+    hashFloat(p.pos.z);
+  }
+
+  printf("bench file=%s layers=%d drones=%d views=%d load_ms=%.1f "
+         "peak_rss_mb=%.1f frames=%d update_mean_ms=%.3f update_p99_ms=%.3f "
+         "update_max_ms=%.3f upload_kb=%.1f seed=%u state_hash=%016llx "
+         "trail_kb=%.1f arena_mb=%.1f arena_used_mb=%.1f",
+         path, (int)droneShow.layers.size(), maxDronesInShow,
+         (int)viewPanes.size(), loadMs,
+         peakResidentSetBytes() / (1024.0 * 1024.0), (int)count,
+         count ? sum / count : 0.0, count ? sorted[count * 99 / 100] : 0.0,
+         count ? sorted.back() : 0.0,
+         (vertexData.size() * sizeof(float) + viewUniformData.size()) / 1024.0,
+         simSeed, (unsigned long long)stateHash,
+         trailPositions.size() * (sizeof(Vec4) + sizeof(uint32_t)) / 1024.0,
+         showArena.capacity() / (1024.0 * 1024.0),
+         showArena.usedBytes() / (1024.0 * 1024.0));
+  // Frames after the warm-up should not allocate at all
+  if (allocTrackingEnabled())
+    printf(" load_allocs=%llu frame_allocs=%llu steady_allocs=%llu "
+           "steady_frames_allocating=%d peak_heap_mb=%.1f\n",
+           (unsigned long long)loadAllocations,
+           (unsigned long long)frameAllocations,
+           (unsigned long long)steadyAllocations, steadyFramesAllocating,
+           allocStats().peakBytes / (1024.0 * 1024.0));
+  else
+    printf(" alloc_tracking=off\n");
+  return 0;
+}
+
+// Times the batch point transform used for view culling against the scalar
+// reference on the same data and reports the largest difference.
+int runMathBenchmark(int pointCount) {
+  typedef std::chrono::steady_clock Clock;
+  const int REPEATS = 20;
+  std::vector<DronePoint> points(pointCount);
+  for (int i = 0; i < pointCount; ++i) {
+    points[i].pos = {std::sin(i * 0.37f) * 300.0f, std::cos(i * 0.11f) * 200.0f,
+                     std::sin(i * 0.05f) * 300.0f};
+  }
+  Mat4 view, projection;
+  computeCamera(mainCamera, 16.0f / 9.0f, view, projection);
+  Mat4 viewProjection = multiply(projection, view);
+  std::vector<Vec4> scalarOut(pointCount), batchOut(pointCount);
+
+  auto time = [&](auto transform, std::vector<Vec4> &out) {
+    double best = 1e30;
+    for (int r = 0; r < REPEATS; ++r) {
+      Clock::time_point start = Clock::now();
+      transform(viewProjection, &points[0].pos, sizeof(DronePoint),
+                (size_t)pointCount, out.data());
+      best = std::min(
+          best,
+          std::chrono::duration<double, std::nano>(Clock::now() - start)
+              .count());
+    }
+    return best / pointCount;
+  };
+  double scalarNs = time(transformPointsScalar, scalarOut);
+  double batchNs = time(transformPoints, batchOut);
+
+  float maxError = 0.0f;
+  for (int i = 0; i < pointCount; ++i) {
+    maxError = std::max({maxError, std::fabs(scalarOut[i].x - batchOut[i].x),
+                         std::fabs(scalarOut[i].y - batchOut[i].y),
+                         std::fabs(scalarOut[i].z - batchOut[i].z),
+                         std::fabs(scalarOut[i].w - batchOut[i].w)});
+  }
+  printf("bench-math points=%d scalar_ns_per_point=%.3f "
+         "batch_ns_per_point=%.3f speedup=%.2f max_error=%g\n",
+         pointCount, scalarNs, batchNs, scalarNs / batchNs, maxError);
+  return maxError < 1e-3f ? 0 : 1;
+}
+
+// --- Baking ---
+// Plays the show (plus any --import images) once from the ground at the
+// simulation tick rate, through takeoff, every layer and the transition back
+// to the first one, and writes every tick to a .dbake file. The file is then
+// decoded again to check it and to measure decode and seek cost. Prints one
+// key=value line.
+int runBake(const char *showPath, const char *outPath, int keyframeInterval,
+            const std::vector<const char *> &imagePaths) {
+  typedef std::chrono::steady_clock Clock;
+  auto msSince = [](Clock::time_point t) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t)
+        .count();
+  };
+  const int CHECKED_DRONES = 64; // Sampled per frame to verify the stream
+  const int SEEKS = 50;
+
+  loadDroneShow(showPath);
+  for (const char *image : imagePaths)
+    importImage(image);
+  if (droneShow.layers.empty() || bakedShow.isOpen() || totalDuration <= 0) {
+    std::cerr << "Nothing to bake in " << showPath << std::endl;
+    return 1;
+  }
+  if (maxDronesInShow > (int)BAKE_MAX_DRONE_COUNT) {
+    std::cerr << "Cannot bake more than " << BAKE_MAX_DRONE_COUNT
+              << " drones (the show needs " << maxDronesInShow << ")"
+              << std::endl;
+    return 1;
+  }
+  enableFireworks = false;
+  TrajectoryEncoder encoder;
+  if (!encoder.open(outPath, droneShow, maxDronesInShow, (float)(1.0 / SIM_DT),
+                    keyframeInterval, BAKE_POSITION_STEP)) {
+    std::cerr << "Could not write " << outPath << std::endl;
+    return 1;
+  }
+
+  std::vector<Vec3> checked;
+  int frames = 0, takeoffEndFrame = 0, wrapFrame = -1;
+  Clock::time_point bakeStart = Clock::now();
+  for (;; ++frames) {
+    encoder.addFrame(animationBuffer, currentLayer,
+                     visibleDroneCount < 0 ? maxDronesInShow
+                                           : visibleDroneCount);
+    for (int k = 0; k < CHECKED_DRONES; ++k)
+      checked.push_back(
+          animationBuffer[(size_t)k * maxDronesInShow / CHECKED_DRONES].pos);
+    // Done once the drones are back in the first formation
+    if (wrapFrame >= 0 && !inTransition)
+      break;
+    bool wasTakingOff = initialAnimationState != DONE;
+    float previousElapsed = elapsedTime;
+    updateSimulation((float)SIM_DT);
+    if (wasTakingOff && initialAnimationState == DONE)
+      takeoffEndFrame = frames + 1;
+    else if (!wasTakingOff && elapsedTime < previousElapsed)
+      wrapFrame = frames + 1;
+  }
+  ++frames;
+  // Looping resumes where the first pass had played as long as the last
+  // frame has after wrapping around
+  if (!encoder.finish(takeoffEndFrame + (frames - wrapFrame))) {
+    std::cerr << "Could not write " << outPath << std::endl;
+    return 1;
+  }
+  double bakeMs = msSince(bakeStart);
+
+  TrajectoryDecoder decoder;
+  std::string error;
+  if (!decoder.open(outPath, error)) {
+    std::cerr << error << std::endl;
+    return 1;
+  }
+  std::vector<DronePoint> decoded;
+  float maxError = 0.0f;
+  Clock::time_point decodeStart = Clock::now();
+  for (int f = 0; f < frames; ++f) {
+    if (!decoder.readFrame(f, decoded)) {
+      std::cerr << "Failed to decode frame " << f << std::endl;
+      return 1;
+    }
+    for (int k = 0; k < CHECKED_DRONES; ++k) {
+      Vec3 d = decoded[(size_t)k * maxDronesInShow / CHECKED_DRONES].pos -
+               checked[(size_t)f * CHECKED_DRONES + k];
+      maxError = std::max({maxError, std::fabs(d.x), std::fabs(d.y),
+                           std::fabs(d.z)});
+    }
+  }
+  double decodeMs = msSince(decodeStart) / frames;
+
+  unsigned int seekSeed = 12345;
+  Clock::time_point seekStart = Clock::now();
+  for (int i = 0; i < SEEKS; ++i) {
+    seekSeed = seekSeed * 1664525u + 1013904223u;
+    decoder.readFrame((seekSeed >> 8) % frames, decoded);
+  }
+  double seekMs = msSince(seekStart) / SEEKS;
+
+  double droneFrames = (double)frames * maxDronesInShow;
+  printf("bake file=%s drones=%d frames=%d keyframe_interval=%d "
+         "bake_ms=%.0f bake_drone_frames_per_s=%.3g raw_mb=%.1f "
+         "file_mb=%.2f ratio=%.1f decode_ms_per_frame=%.3f seek_ms=%.3f "
+         "max_error=%g\n",
+         outPath, maxDronesInShow, frames, (int)encoder.header.keyframeInterval,
+         bakeMs, droneFrames / (bakeMs / 1000.0),
+         encoder.rawBytes / (1024.0 * 1024.0),
+         encoder.fileBytes / (1024.0 * 1024.0),
+         (double)encoder.rawBytes / encoder.fileBytes, decodeMs, seekMs,
+         maxError);
+  return maxError <= BAKE_POSITION_STEP ? 0 : 1;
+}
+
+// --- Thumbnail Sheet ---
+// Renders every layer's thumbnail with the CPU rasterizer, laid out like
+// the atlas, and writes it as a PPM. Needs no window. Prints one key=value
+// line.
+int runThumbnailSheet(const char *showPath, const char *outPath,
+                      const std::vector<const char *> &imagePaths) {
+  typedef std::chrono::steady_clock Clock;
+  loadDroneShow(showPath);
+  for (const char *image : imagePaths)
+    importImage(image);
+  Clock::time_point start = Clock::now();
+  std::string error;
+  if (!writeThumbnailSheet(droneShow.layers, outPath, error)) {
+    std::cerr << "Could not write " << outPath << ": " << error << std::endl;
+    return 1;
+  }
+  double ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  size_t points = 0;
+  for (const auto &l : droneShow.layers)
+    points += l.points.size();
+  printf("thumbnails file=%s layers=%d points=%zu tile=%d out=%s ms=%.1f "
+         "ms_per_layer=%.3f\n",
+         showPath, (int)droneShow.layers.size(), points, THUMBNAIL_SIZE,
+         outPath, ms, ms / droneShow.layers.size());
+  return 0;
+}
+
+void printUsage(const char *program) {
+  std::cerr << "Usage: " << program << " [show.json|show.dshow] [--seed N]"
+            << " [--views N] [--trails] [--import image.png"
+            << " [--import-drones N]"
+            << " [--import-spacing S]]\n"
+            << "       " << program
+            << " --bench <show> [--frames N] [--seeks N] [--speed X]"
+            << " [--seed N] [--fireworks] [--views N] [--trails]\n"
+            << "       " << program
+            << " <show> --bake out.dbake [--keyframe-interval N]\n"
+            << "       " << program << " <show> --thumbnails out.ppm\n"
+            << "       " << program << " --bench-math [points]" << std::endl;
+}
+
+int main(int argc, char **argv) {
+  const char *showPath = "assets/example-drone-show.json";
+  const char *benchPath = nullptr, *bakePath = nullptr;
+  const char *thumbnailPath = nullptr;
+  int keyframeInterval = 60;
+  int benchFrames = 600, benchSeeks = 20;
+  bool seedGiven = false;
+  std::vector<const char *> imagePaths;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--bench" && hasValue) {
+      benchPath = argv[++i];
+    } else if (arg == "--bench-math") {
+      int points = hasValue ? atoi(argv[i + 1]) : 0;
+      return runMathBenchmark(points > 0 ? points : 1000000);
+    } else if (arg == "--import" && hasValue) {
+      imagePaths.push_back(argv[++i]);
+    } else if (arg == "--import-drones" && hasValue) {
+      importOptions.droneCount = std::max(1, atoi(argv[++i]));
+    } else if (arg == "--import-spacing" && hasValue) {
+      importOptions.minSeparation = atof(argv[++i]);
+    } else if (arg == "--frames" && hasValue) {
+      benchFrames = atoi(argv[++i]);
+    } else if (arg == "--seeks" && hasValue) {
+      benchSeeks = atoi(argv[++i]);
+    } else if (arg == "--speed" && hasValue) {
+      playbackSpeed = atof(argv[++i]);
+    } else if (arg == "--seed" && hasValue) {
+      simSeed = strtoul(argv[++i], NULL, 10);
+      seedGiven = true;
+    } else if (arg == "--bake" && hasValue) {
+      bakePath = argv[++i];
+    } else if (arg == "--thumbnails" && hasValue) {
+      thumbnailPath = argv[++i];
+    } else if (arg == "--keyframe-interval" && hasValue) {
+      keyframeInterval = std::max(1, atoi(argv[++i]));
+    } else if (arg == "--views" && hasValue) {
+      int views = atoi(argv[++i]);
+      splitScreen = views > 1;
+      splitViewCount = std::min(std::max(views, 2), MAX_VIEWS);
+    } else if (arg == "--fireworks") {
+      enableFireworks = true;
+    } else if (arg == "--trails") {
+      enableTrails = true;
+    } else if (arg[0] != '-') {
+      showPath = argv[i];
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  particleBudget = governor.settings().particleBudget;
+  initSplitCameras();
+  // Sized once so steady-state playback never grows them
+  particles.reserve(MAX_FIREWORK_PARTICLES);
+  simCommands.reserve(64);
+  simCommandsInFlight.reserve(64);
+  if (allocTrackingEnabled()) {
+    cJSON_Hooks hooks = {trackedMalloc, trackedFree};
+    cJSON_InitHooks(&hooks);
+    ImGui::SetAllocatorFunctions(
+        [](size_t size, void *) { return trackedMalloc(size); },
+        [](void *ptr, void *) { trackedFree(ptr); });
+  }
+  if (benchPath)
+    return runBenchmark(benchPath, benchFrames, benchSeeks, imagePaths);
+  if (bakePath)
+    return runBake(showPath, bakePath, keyframeInterval, imagePaths);
+  if (thumbnailPath)
+    return runThumbnailSheet(showPath, thumbnailPath, imagePaths);
+
   if (!glfwInit())
     return -1;
   const char *glsl_version = "#version 330";
@@ -542,11 +2045,20 @@ int main() {
   ImGui_ImplGlfw_InitForOpenGL(window, true);
   ImGui_ImplOpenGL3_Init(glsl_version);
 
-  srand(time(NULL));
+  if (!seedGiven)
+    simSeed = (unsigned int)time(NULL);
+  std::cout << "Simulation seed: " << simSeed << std::endl;
 
-  loadDroneShow("assets/example-drone-show.json");
+  loadDroneShow(showPath);
+  for (const char *image : imagePaths)
+    importImage(image);
   droneShaderProgram = createShaderProgram("src/shader.vert", "src/shader.frag",
                                            "src/shader.geom");
+  trailShaderProgram =
+      createShaderProgram("src/trail.vert", "src/trail.frag");
+  thumbnailShaderProgram =
+      createShaderProgram("src/thumbnail.vert", "src/thumbnail.frag");
+  thumbnails.init();
   droneTexture = loadTexture("assets/drone.png");
 
   GLuint VAO, VBO;
@@ -559,206 +2071,49 @@ int main() {
   glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 7 * sizeof(float),
                         (void *)(3 * sizeof(float)));
   glEnableVertexAttribArray(1);
+
+  // Per-view uniform blocks, bound one range at a time
+  GLuint viewUBO;
+  glGenBuffers(1, &viewUBO);
+  GLint uniformAlignment = 256;
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+  uniformAlignment = std::max(uniformAlignment, 1);
+  viewUniformStride = ((int)sizeof(ViewUniforms) + uniformAlignment - 1) /
+                      uniformAlignment * uniformAlignment;
+  glUniformBlockBinding(
+      droneShaderProgram,
+      glGetUniformBlockIndex(droneShaderProgram, "ViewBlock"), 0);
+  glUniformBlockBinding(
+      trailShaderProgram,
+      glGetUniformBlockIndex(trailShaderProgram, "ViewBlock"), 0);
   glEnable(GL_DEPTH_TEST);
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  gpuTimer.init();
 
-  float lastFrameTime = 0.0f;
+  startSimulation();
+  int postedParticleBudget = particleBudget;
   while (!glfwWindowShouldClose(window)) {
-    float currentFrameTime = glfwGetTime();
-    float deltaTime = currentFrameTime - lastFrameTime;
-    lastFrameTime = currentFrameTime;
-    float effectiveDeltaTime = deltaTime * playbackSpeed;
-
-    if (initialAnimationState != DONE) {
-      switch (initialAnimationState) {
-      case PRE_TAKEOFF: {
-        preTakeoffTime += effectiveDeltaTime * 1000;
-        if (preTakeoffTime >= PRE_TAKEOFF_DURATION) {
-          initialAnimationState = TAKING_OFF;
-          transitionElapsedTime = 0.0f;
-        }
-        break;
-      }
-      case TAKING_OFF: {
-        transitionElapsedTime += effectiveDeltaTime * 1000;
-        float t = std::min(1.0f, transitionElapsedTime / transitionDuration);
-        float eased_t = easeOutCubic(t);
-
-        const auto &startPoints = groundFormation.points;
-        const auto &endPoints = droneShow.layers[0].points;
-
-        for (size_t i = 0; i < (size_t)maxDronesInShow; ++i) {
-          bool inEnd = i < endPoints.size();
-          Vec3 startPos = startPoints[i].pos;
-          Vec3 endPos = inEnd ? endPoints[i].pos : startPos;
-
-          animationBuffer[i].pos = naturalLerp(startPos, endPos, eased_t, i);
-          Vec4 startColor = startPoints[i].color;
-          Vec4 endColor = inEnd ? endPoints[i].color : Vec4{0, 0, 0, 0};
-          animationBuffer[i].color = lerp(startColor, endColor, eased_t);
-        }
-
-        if (t >= 1.0f) {
-          initialAnimationState = DONE;
-          const auto &finalPoints = droneShow.layers[0].points;
-          for (size_t i = 0; i < finalPoints.size(); ++i) {
-            animationBuffer[i] = finalPoints[i];
-          }
-          for (size_t i = finalPoints.size(); i < (size_t)maxDronesInShow;
-               ++i) {
-            animationBuffer[i].pos = {0, -200.0f, 0};
-            animationBuffer[i].color = {0, 0, 0, 0};
-          }
-          visibleDroneCount = finalPoints.size();
-          elapsedTime = 0.0f;
-          isPlaying = true;
-        }
-        break;
-      }
-      case DONE:
-        break;
-      }
-    } else if (isPlaying) {
-      elapsedTime += effectiveDeltaTime * 1000;
-      if (elapsedTime >= totalDuration && totalDuration > 0) {
-        if (enableFireworks) {
-          spawnFireworks();
-        }
-        elapsedTime = fmod(elapsedTime, totalDuration);
-        if (currentLayer != 0)
-          triggerTransition(0);
-      }
-
-      timelinePosition = totalDuration > 0 ? elapsedTime / totalDuration : 0;
-      float time_cursor = 0.0f;
-      for (size_t i = 0; i < droneShow.layers.size(); ++i) {
-        time_cursor += droneShow.layers[i].duration;
-        if (elapsedTime < time_cursor) {
-          if (currentLayer != (int)i && !inTransition)
-            triggerTransition((int)i);
-          break;
-        }
-      }
-    }
-
-    if (inTransition) {
-      transitionElapsedTime += effectiveDeltaTime * 1000;
-      float t = std::min(1.0f, transitionElapsedTime / transitionDuration);
-      float eased_t = easeOutCubic(t);
-      const auto &startPoints = droneShow.layers[previousLayer].points;
-      const auto &endPoints = droneShow.layers[currentLayer].points;
-
-      for (size_t i = 0; i < (size_t)maxDronesInShow; ++i) {
-        bool inStart = i < startPoints.size();
-        bool inEnd = i < endPoints.size();
-        Vec3 startPos, endPos;
-
-        if (inStart && inEnd) { // Exists in both, normal transition
-          startPos = startPoints[i].pos;
-          endPos = endPoints[i].pos;
-        } else if (inStart) { // Disappearing drone
-          startPos = startPoints[i].pos;
-          // Fly outwards to surroundings
-          Vec3 dir = {startPoints[i].pos.x, 0, startPoints[i].pos.z};
-          if (dot(dir, dir) < 0.1f)
-            dir = {(float)sin(i), 0, (float)cos(i)};
-          dir = normalize(dir);
-          endPos = dir * 500.0f;           // Fly far away
-          endPos.y = startPoints[i].pos.y; // Keep height
-
-        } else if (inEnd) { // Appearing drone
-          startPos = {endPoints[i].pos.x + (float)sin(i) * 50.0f, -250.0f,
-                      endPoints[i].pos.z + (float)cos(i) * 50.0f};
-          endPos = endPoints[i].pos;
-        } else { // Inactive drone
-          startPos = endPos = {0, -200.0f, 0};
-        }
+    uint64_t frameStartAllocations = allocStats().allocations;
+    double updateStartTime = glfwGetTime();
+    acquireSnapshot();
+    interpolateSnapshot(snapshotAlpha(clockSeconds()));
 
-        animationBuffer[i].pos = naturalLerp(startPos, endPos, eased_t, i);
-
-        Vec4 startColor = inStart ? startPoints[i].color : Vec4{0, 0, 0, 0};
-        Vec4 endColor = inEnd ? endPoints[i].color : Vec4{0, 0, 0, 0};
-        animationBuffer[i].color = lerp(startColor, endColor, eased_t);
-      }
-
-      if (t >= 1.0f) {
-        inTransition = false;
-        const auto &finalPoints = droneShow.layers[currentLayer].points;
-        for (size_t i = 0; i < finalPoints.size(); ++i) {
-          animationBuffer[i] = finalPoints[i];
-        }
-        for (size_t i = finalPoints.size(); i < (size_t)maxDronesInShow; ++i) {
-          animationBuffer[i].pos = {0, -200.0f, 0};
-          animationBuffer[i].color = {0, 0, 0, 0};
-        }
-        visibleDroneCount = finalPoints.size();
-      }
-    }
-
-    // Update and manage particles
-    bool hadParticles = !particles.empty();
-    if (!particles.empty()) {
-      float gravity = 20.0f;
-      for (auto it = particles.begin(); it != particles.end();) {
-        it->pos = it->pos + it->vel * effectiveDeltaTime;
-        it->vel.y -= gravity * effectiveDeltaTime;
-        it->lifetime -= effectiveDeltaTime;
-        if (it->lifetime <= 0) {
-          it = particles.erase(it);
-        } else {
-          ++it;
-        }
-      }
-    }
-    
-    if (hadParticles && particles.empty() && enableFireworks) {
-        isPlaying = false;
-        // Reset to Pre-Takeoff state
-        initialAnimationState = PRE_TAKEOFF;
-        preTakeoffTime = 0.0f;
-        elapsedTime = 0.0f;
-        timelinePosition = 0.0f;
-        currentLayer = 0;
-        previousLayer = 0;
-        transitionElapsedTime = 0.0f;
-        
-        // Reset positions to ground formation
-        if (!groundFormation.points.empty()) {
-             animationBuffer.assign(groundFormation.points.begin(),
-                                    groundFormation.points.end());
-             animationBuffer.resize(maxDronesInShow);
-             visibleDroneCount = maxDronesInShow;
-        }
-    }
-
-    int numDronesToRender =
-        (visibleDroneCount == -1)
-            ? animationBuffer.size()
-            : std::min((size_t)visibleDroneCount, animationBuffer.size());
-    vertexData.clear();
-    vertexData.reserve(numDronesToRender * 7 + particles.size() * 7);
-    for (int i = 0; i < numDronesToRender; ++i) {
-      const auto &p = animationBuffer[i];
-      vertexData.push_back(p.pos.x);
-      vertexData.push_back(p.pos.y);
-      vertexData.push_back(p.pos.z);
-      vertexData.push_back(p.color.x);
-      vertexData.push_back(p.color.y);
-      vertexData.push_back(p.color.z);
-      vertexData.push_back(p.color.w);
-    }
-
-    // Add particles to vertex data
-    for (const auto &p : particles) {
-      vertexData.push_back(p.pos.x);
-      vertexData.push_back(p.pos.y);
-      vertexData.push_back(p.pos.z);
-      vertexData.push_back(p.color.x);
-      vertexData.push_back(p.color.y);
-      vertexData.push_back(p.color.z);
-      vertexData.push_back(p.color.w);
-    }
+    int display_w, display_h;
+    glfwGetFramebufferSize(window, &display_w, &display_h);
+    // Draw the scene at reduced resolution when the governor asks for it
+    const QualitySettings &quality = governor.settings();
+    int render_w = std::max(1, (int)(display_w * quality.renderScale));
+    int render_h = std::max(1, (int)(display_h * quality.renderScale));
+    layoutViews(render_w, render_h);
+    buildVertexData();
+    if (enableTrails)
+      buildTrailRow();
+    float cpuUpdateMs = (glfwGetTime() - updateStartTime) * 1000.0;
+
+    // A few stale thumbnail tiles per frame, before the UI shows them
+    thumbnails.sync(droneShow.layers.size(), showRevision);
+    thumbnails.update(droneShow.layers, thumbnailShaderProgram);
 
     glfwPollEvents();
     ImGui_ImplOpenGL3_NewFrame();
@@ -766,69 +2121,110 @@ int main() {
     ImGui::NewFrame();
     renderUI();
 
-    int display_w, display_h;
-    glfwGetFramebufferSize(window, &display_w, &display_h);
-    glViewport(0, 0, display_w, display_h);
-    glClearColor(0.1f, 0.1f, 0.12f, 1.0f);
+    bool offscreen = quality.renderScale < 1.0f &&
+                     sceneTarget.resize(render_w, render_h);
+    if (!offscreen && sceneTarget.fbo)
+      sceneTarget.destroy();
+
+    gpuTimer.begin();
+    glBindFramebuffer(GL_FRAMEBUFFER, offscreen ? sceneTarget.fbo : 0);
+    if (offscreen)
+      glViewport(0, 0, render_w, render_h);
+    else
+      glViewport(0, 0, display_w, display_h);
+    // In split screen the gaps between panes keep this color
+    if (viewPanes.size() > 1)
+      glClearColor(0.3f, 0.3f, 0.33f, 1.0f);
+    else
+      glClearColor(0.1f, 0.1f, 0.12f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    if (!vertexData.empty()) {
+    // A jump (reset to ground, baked seek) would connect the old and new
+    // positions, so the trails start over
+    if (currentSnapshot.generation != trailGeneration) {
+      trails.reset();
+      trailGeneration = currentSnapshot.generation;
+    }
+    if (enableTrails && !trails.push(trailPositions, trailColors)) {
+      enableTrails = false;
+      trailStatus = "Too many drones for trails (" +
+                    std::to_string(trails.budgetBytes >> 20) +
+                    " MB budget)";
+      std::cerr << trailStatus << std::endl;
+    }
+    if (!enableTrails)
+      trails.destroy();
+
+    bool drawDrones = !vertexData.empty();
+    if (drawDrones) {
+      // Drones and view uniforms are uploaded once; each pane only rebinds
+      // its uniform range and draws the same buffer again.
       glBindBuffer(GL_ARRAY_BUFFER, VBO);
       glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float),
                    vertexData.data(), GL_DYNAMIC_DRAW);
+      glBindBuffer(GL_UNIFORM_BUFFER, viewUBO);
+      glBufferData(GL_UNIFORM_BUFFER, viewUniformData.size(),
+                   viewUniformData.data(), GL_STREAM_DRAW);
 
       glUseProgram(droneShaderProgram);
-      Mat4 model = identity(), view, projection;
-      float aspect = (float)display_w / (float)display_h;
-      Vec3 camPos;
-
-      switch (currentViewMode) {
-      case VIEW_3D:
-        camPos.x =
-            cameraTarget.x + cameraRadius * cos(cameraPitch) * cos(cameraYaw);
-        camPos.y = cameraTarget.y + cameraRadius * sin(cameraPitch);
-        camPos.z =
-            cameraTarget.z + cameraRadius * cos(cameraPitch) * sin(cameraYaw);
-        projection = perspective(45.0f, aspect, 0.1f, 5000.0f);
-        view = lookAt(camPos, cameraTarget, {0, 1, 0});
-        break;
-      case VIEW_2D_TOP:
-        projection = orthographic(-orthoSize * aspect, orthoSize * aspect,
-                                  -orthoSize, orthoSize, -1000.0f, 1000.0f);
-        view = lookAt({cameraTarget.x, 500, cameraTarget.z}, cameraTarget,
-                      {0, 0, -1});
-        break;
-      case VIEW_2D_FRONT:
-        projection = orthographic(-orthoSize * aspect, orthoSize * aspect,
-                                  -orthoSize, orthoSize, -1000.0f, 5000.0f);
-        view = lookAt({cameraTarget.x, cameraTarget.y, 500}, cameraTarget,
-                      {0, 1, 0});
-        break;
-      }
-      glUniformMatrix4fv(glGetUniformLocation(droneShaderProgram, "model"), 1,
-                         GL_FALSE, model.m);
-      glUniformMatrix4fv(glGetUniformLocation(droneShaderProgram, "view"), 1,
-                         GL_FALSE, view.m);
-      glUniformMatrix4fv(glGetUniformLocation(droneShaderProgram, "projection"),
-                         1, GL_FALSE, projection.m);
       glUniform1f(glGetUniformLocation(droneShaderProgram, "drone_size"),
                   droneSize);
+      glUniform1f(glGetUniformLocation(droneShaderProgram, "mipBias"),
+                  quality.mipBias);
 
       glActiveTexture(GL_TEXTURE0);
       glBindTexture(GL_TEXTURE_2D, droneTexture);
       glUniform1i(glGetUniformLocation(droneShaderProgram, "droneTexture"), 0);
 
       glBindVertexArray(VAO);
-      glDrawArrays(GL_POINTS, 0, vertexData.size() / 7);
     }
+    glEnable(GL_SCISSOR_TEST);
+    glClearColor(0.1f, 0.1f, 0.12f, 1.0f);
+    for (size_t i = 0; i < viewPanes.size(); ++i) {
+      const ViewPane &pane = viewPanes[i];
+      glViewport(pane.pixelX, pane.pixelY, pane.pixelW, pane.pixelH);
+      glScissor(pane.pixelX, pane.pixelY, pane.pixelW, pane.pixelH);
+      if (viewPanes.size() > 1)
+        glClear(GL_COLOR_BUFFER_BIT);
+      if (drawDrones) {
+        glBindBufferRange(GL_UNIFORM_BUFFER, 0, viewUBO,
+                          i * viewUniformStride, sizeof(ViewUniforms));
+        if (enableTrails) {
+          trails.draw(trailShaderProgram);
+          glUseProgram(droneShaderProgram);
+          glBindVertexArray(VAO);
+        }
+        glDrawArrays(GL_POINTS, 0, vertexData.size() / 7);
+      }
+    }
+    glDisable(GL_SCISSOR_TEST);
+    if (offscreen)
+      sceneTarget.blitToScreen(display_w, display_h);
+    glViewport(0, 0, display_w, display_h);
     ImGui::Render();
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    gpuTimer.end();
     glfwSwapBuffers(window);
+
+    governor.update(cpuUpdateMs, gpuTimer.lastMs);
+    if (governor.settings().particleBudget != postedParticleBudget) {
+      postedParticleBudget = governor.settings().particleBudget;
+      postSimCommand(SIM_SET_PARTICLE_BUDGET, postedParticleBudget);
+    }
+    lastFrameAllocations = allocStats().allocations - frameStartAllocations;
   }
 
+  stopSimulation();
+  gpuTimer.destroy();
+  sceneTarget.destroy();
+  trails.destroy();
+  thumbnails.destroy();
   glDeleteVertexArrays(1, &VAO);
   glDeleteBuffers(1, &VBO);
+  glDeleteBuffers(1, &viewUBO);
   glDeleteProgram(droneShaderProgram);
+  glDeleteProgram(trailShaderProgram);
+  glDeleteProgram(thumbnailShaderProgram);
   glDeleteTextures(1, &droneTexture);
   ImGui_ImplOpenGL3_Shutdown();
   ImGui_ImplGlfw_Shutdown();
@@ -839,17 +2235,29 @@ int main() {
 }
 
 // --- GLFW Callbacks ---
+// Mouse input goes to the camera of the pane under the cursor.
+ViewCamera *cameraUnderCursor(GLFWwindow *window) {
+  double x, y;
+  int width, height;
+  glfwGetCursorPos(window, &x, &y);
+  glfwGetWindowSize(window, &width, &height);
+  ViewPane *pane = paneAt((float)(x / std::max(width, 1)),
+                          (float)(y / std::max(height, 1)));
+  return pane ? pane->camera : &mainCamera;
+}
+
 void scroll_callback(GLFWwindow *window, double xoffset, double yoffset) {
   if (ImGui::GetIO().WantCaptureMouse)
     return;
-  if (currentViewMode == VIEW_3D) {
-    cameraRadius -= yoffset * 20.0f;
-    if (cameraRadius < 1.0f)
-      cameraRadius = 1.0f;
+  ViewCamera &camera = *cameraUnderCursor(window);
+  if (camera.mode == VIEW_3D) {
+    camera.radius -= yoffset * 20.0f;
+    if (camera.radius < 1.0f)
+      camera.radius = 1.0f;
   } else {
-    orthoSize -= yoffset * 20.0f;
-    if (orthoSize < 10.0f)
-      orthoSize = 10.0f;
+    camera.orthoSize -= yoffset * 20.0f;
+    if (camera.orthoSize < 10.0f)
+      camera.orthoSize = 10.0f;
   }
 }
 
@@ -859,31 +2267,36 @@ void mouse_button_callback(GLFWwindow *window, int button, int action,
     return;
   if (button == GLFW_MOUSE_BUTTON_LEFT) {
     if (action == GLFW_PRESS) {
-      isDragging = true;
+      dragCamera = cameraUnderCursor(window);
       glfwGetCursorPos(window, &lastMouseX, &lastMouseY);
     } else if (action == GLFW_RELEASE) {
-      isDragging = false;
+      dragCamera = nullptr;
     }
   }
 }
 
 void cursor_position_callback(GLFWwindow *window, double xpos, double ypos) {
-  if (!isDragging)
+  if (!dragCamera)
     return;
   float deltaX = xpos - lastMouseX;
   float deltaY = ypos - lastMouseY;
   lastMouseX = xpos;
   lastMouseY = ypos;
 
-  if (currentViewMode == VIEW_3D) {
-    cameraYaw += deltaX * 0.005f;
-    cameraPitch -= deltaY * 0.005f;
-    if (cameraPitch > PI / 2.0f - 0.01f)
-      cameraPitch = PI / 2.0f - 0.01f;
-    if (cameraPitch < -PI / 2.0f + 0.01f)
-      cameraPitch = -PI / 2.0f + 0.01f;
+  ViewCamera &camera = *dragCamera;
+  float panScale = camera.orthoSize / 500.0f;
+  if (camera.mode == VIEW_3D) {
+    camera.yaw += deltaX * 0.005f;
+    camera.pitch -= deltaY * 0.005f;
+    if (camera.pitch > PI / 2.0f - 0.01f)
+      camera.pitch = PI / 2.0f - 0.01f;
+    if (camera.pitch < -PI / 2.0f + 0.01f)
+      camera.pitch = -PI / 2.0f + 0.01f;
+  } else if (camera.mode == VIEW_2D_TOP) { // Screen up is -z
+    camera.target.x -= deltaX * panScale;
+    camera.target.z -= deltaY * panScale;
   } else { // 2D Pan
-    cameraTarget.x -= deltaX * (orthoSize / 500.0f);
-    cameraTarget.y += deltaY * (orthoSize / 500.0f);
+    camera.target.x -= deltaX * panScale;
+    camera.target.y += deltaY * panScale;
   }
 }
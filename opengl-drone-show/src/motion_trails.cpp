@@ -0,0 +1,102 @@
+#define GLEW_STATIC
+#include "motion_trails.h"
+
+#include <algorithm>
+
+void MotionTrails::reset() {
+  samples = 0;
+  framesSinceSample = 0;
+}
+
+bool MotionTrails::push(const std::vector<Vec4> &positions,
+                        const std::vector<uint32_t> &colors) {
+  int slots = (int)positions.size();
+  if (slots == 0)
+    return true;
+  if (slots != slotCount || length != requestedLength) {
+    destroy();
+    if (!maxTexels)
+      glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    size_t texels = std::min((size_t)maxTexels, budgetBytes / sizeof(Vec4));
+    int rows = (int)std::min(texels / slots, (size_t)std::max(length, 2));
+    if (rows < 2)
+      return false;
+    slotCount = slots;
+    requestedLength = length;
+    ringLength = rows;
+    glGenVertexArrays(1, &vao);
+
+    glGenBuffers(1, &ringBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, ringBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, ringBytes(), NULL, GL_DYNAMIC_DRAW);
+    glGenTextures(1, &ringTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, ringTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, ringBuffer);
+
+    glGenBuffers(1, &colorBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, colorBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, (size_t)slotCount * 4, NULL,
+                 GL_DYNAMIC_DRAW);
+    glGenTextures(1, &colorTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, colorTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA8, colorBuffer);
+    reset();
+  }
+
+  // The newest row follows the points every frame; a new row is started
+  // every `spacing` frames, overwriting the oldest.
+  if (samples == 0 || ++framesSinceSample >= spacing) {
+    head = samples == 0 ? 0 : (head + 1) % ringLength;
+    samples = std::min(samples + 1, ringLength);
+    framesSinceSample = 0;
+  }
+  size_t rowBytes = (size_t)slotCount * sizeof(Vec4);
+  glBindBuffer(GL_TEXTURE_BUFFER, ringBuffer);
+  glBufferSubData(GL_TEXTURE_BUFFER, head * rowBytes, rowBytes,
+                  positions.data());
+  glBindBuffer(GL_TEXTURE_BUFFER, colorBuffer);
+  glBufferSubData(GL_TEXTURE_BUFFER, 0, (size_t)slotCount * 4, colors.data());
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+  return true;
+}
+
+void MotionTrails::draw(GLuint program) const {
+  if (samples < 2)
+    return;
+  glUseProgram(program);
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_BUFFER, ringTexture);
+  glActiveTexture(GL_TEXTURE2);
+  glBindTexture(GL_TEXTURE_BUFFER, colorTexture);
+  glActiveTexture(GL_TEXTURE0);
+  glUniform1i(glGetUniformLocation(program, "trailPositions"), 1);
+  glUniform1i(glGetUniformLocation(program, "trailColors"), 2);
+  glUniform1i(glGetUniformLocation(program, "slotCount"), slotCount);
+  glUniform1i(glGetUniformLocation(program, "ringLength"), ringLength);
+  glUniform1i(glGetUniformLocation(program, "head"), head);
+  glUniform1i(glGetUniformLocation(program, "sampleCount"), samples);
+  glUniform1f(glGetUniformLocation(program, "fade"), fade);
+
+  // Trails are translucent and sit behind the drones: test depth but do not
+  // write it
+  glDepthMask(GL_FALSE);
+  glBindVertexArray(vao);
+  glDrawArraysInstanced(GL_LINES, 0, 2 * (samples - 1), slotCount);
+  glDepthMask(GL_TRUE);
+}
+
+void MotionTrails::destroy() {
+  if (vao)
+    glDeleteVertexArrays(1, &vao);
+  if (ringTexture)
+    glDeleteTextures(1, &ringTexture);
+  if (ringBuffer)
+    glDeleteBuffers(1, &ringBuffer);
+  if (colorTexture)
+    glDeleteTextures(1, &colorTexture);
+  if (colorBuffer)
+    glDeleteBuffers(1, &colorBuffer);
+  vao = ringBuffer = ringTexture = colorBuffer = colorTexture = 0;
+  slotCount = ringLength = requestedLength = 0;
+  reset();
+}
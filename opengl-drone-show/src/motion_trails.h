@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "vec_math.h"
+
+// --- Motion Trails ---
+// Light-painting trails kept entirely on the GPU. Every point that can leave
+// a trail (each drone, each firework particle) owns a fixed slot. The ring
+// buffer holds `length` rows of one position per slot, read through a
+// texture buffer. Each frame only the newest row is uploaded, so the CPU
+// cost is one pass over the slots however long the trails are. trail.vert
+// rebuilds the segments from the ring in a single instanced draw, one
+// instance per slot.
+struct MotionTrails {
+  int length = 24;   // Samples kept per slot
+  int spacing = 2;   // Frames between samples
+  float fade = 1.5f; // Exponent of the fade toward the tail
+  // Ring memory limit; `length` is shortened to stay inside it and inside
+  // the driver's texture buffer size
+  size_t budgetBytes = (size_t)256 << 20;
+
+  // Forgets the recorded samples, e.g. after a seek, so no trail spans a
+  // jump.
+  void reset();
+  // Records this frame's slot positions (w = alpha, 0 where the slot is
+  // unused) and colors (RGBA8). Resizes the ring when the slot count or
+  // length changed. Returns false, keeping nothing, when not even two
+  // samples per slot fit the budget.
+  bool push(const std::vector<Vec4> &positions,
+            const std::vector<uint32_t> &colors);
+  // Draws the trails with `program` (trail.vert/.frag), whose ViewBlock the
+  // caller has already bound.
+  void draw(GLuint program) const;
+  void destroy();
+
+  size_t ringBytes() const { return (size_t)slotCount * ringLength * 16; }
+  // Samples actually kept, below `length` when the budget cut it
+  int keptLength() const { return ringLength; }
+
+private:
+  GLuint vao = 0;
+  GLuint ringBuffer = 0, ringTexture = 0; // RGBA32F, ringLength rows
+  GLuint colorBuffer = 0, colorTexture = 0; // RGBA8, one per slot
+  int slotCount = 0, ringLength = 0;
+  int requestedLength = 0; // `length` the ring was sized for
+  GLint maxTexels = 0;     // GL_MAX_TEXTURE_BUFFER_SIZE, queried once
+  int head = 0;    // Row holding the newest sample
+  int samples = 0; // Valid rows, at most ringLength
+  int framesSinceSample = 0;
+};
@@ -0,0 +1,150 @@
+#define GLEW_STATIC
+#include "quality_governor.h"
+
+#include <algorithm>
+
+// --- Quality Ladder ---
+static const QualitySettings QUALITY_LEVELS[] = {
+    // particles, cull px, mip bias, render scale
+    {4000, 0.0f, 0.0f, 1.0f},
+    {2000, 0.5f, 0.5f, 1.0f},
+    {1000, 1.0f, 1.0f, 0.85f},
+    {500, 1.5f, 1.5f, 0.7f},
+    {250, 2.0f, 2.0f, 0.5f},
+};
+static const int LEVEL_COUNT =
+    sizeof(QUALITY_LEVELS) / sizeof(QUALITY_LEVELS[0]);
+
+// Hysteresis: dropping quality reacts within a few frames, raising it again
+// needs a long stretch of comfortable headroom, and every change is followed
+// by a cooldown so the new level can be measured before judging it.
+static const float SMOOTHING = 0.1f;
+static const float DOWNGRADE_RATIO = 1.0f;
+static const float UPGRADE_RATIO = 0.7f;
+static const int DOWNGRADE_FRAMES = 10;
+static const int UPGRADE_FRAMES = 120;
+static const int COOLDOWN_FRAMES = 60;
+
+int QualityGovernor::levelCount() { return LEVEL_COUNT; }
+
+const QualitySettings &QualityGovernor::settings() const {
+  return QUALITY_LEVELS[std::min(std::max(level, 0), LEVEL_COUNT - 1)];
+}
+
+void QualityGovernor::update(float cpuFrameMs, float gpuFrameMs) {
+  cpuMs += (cpuFrameMs - cpuMs) * SMOOTHING;
+  gpuMs += (gpuFrameMs - gpuMs) * SMOOTHING;
+  if (!enabled) {
+    overBudgetFrames = underBudgetFrames = cooldownFrames = 0;
+    return;
+  }
+  if (cooldownFrames > 0) {
+    --cooldownFrames;
+    return;
+  }
+
+  // CPU and GPU work overlap, so the slower of the two bounds the frame.
+  float frameMs = std::max(cpuMs, gpuMs);
+  overBudgetFrames =
+      frameMs > targetFrameMs * DOWNGRADE_RATIO ? overBudgetFrames + 1 : 0;
+  underBudgetFrames =
+      frameMs < targetFrameMs * UPGRADE_RATIO ? underBudgetFrames + 1 : 0;
+
+  if (overBudgetFrames >= DOWNGRADE_FRAMES && level < LEVEL_COUNT - 1) {
+    ++level;
+    lastDecision = cpuMs > gpuMs ? "Lowered quality (CPU bound)"
+                                 : "Lowered quality (GPU bound)";
+  } else if (underBudgetFrames >= UPGRADE_FRAMES && level > 0) {
+    --level;
+    lastDecision = "Raised quality (headroom)";
+  } else {
+    return;
+  }
+  overBudgetFrames = underBudgetFrames = 0;
+  cooldownFrames = COOLDOWN_FRAMES;
+}
+
+// --- GPU Timer ---
+void GpuTimer::init() { glGenQueries(QUERY_COUNT, queries); }
+
+void GpuTimer::begin() {
+  // All queries busy: drop this frame's measurement rather than wait.
+  if (pending == QUERY_COUNT)
+    return;
+  glBeginQuery(GL_TIME_ELAPSED, queries[writeIndex]);
+}
+
+void GpuTimer::end() {
+  if (pending < QUERY_COUNT) {
+    glEndQuery(GL_TIME_ELAPSED);
+    writeIndex = (writeIndex + 1) % QUERY_COUNT;
+    ++pending;
+  }
+
+  // Collect every finished query, oldest first.
+  while (pending > 0) {
+    GLuint oldest = queries[(writeIndex - pending + QUERY_COUNT) % QUERY_COUNT];
+    GLint available = 0;
+    glGetQueryObjectiv(oldest, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+      break;
+    GLuint64 elapsedNs = 0;
+    glGetQueryObjectui64v(oldest, GL_QUERY_RESULT, &elapsedNs);
+    lastMs = elapsedNs / 1.0e6f;
+    --pending;
+  }
+}
+
+void GpuTimer::destroy() { glDeleteQueries(QUERY_COUNT, queries); }
+
+// --- Offscreen Render Target ---
+bool RenderTarget::resize(int w, int h) {
+  if (fbo && w == width && h == height)
+    return true;
+  destroy();
+  width = w;
+  height = h;
+
+  glGenTextures(1, &colorTexture);
+  glBindTexture(GL_TEXTURE_2D, colorTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+               NULL);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+  glGenRenderbuffers(1, &depthBuffer);
+  glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, w, h);
+
+  glGenFramebuffers(1, &fbo);
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                         colorTexture, 0);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                            GL_RENDERBUFFER, depthBuffer);
+  bool complete =
+      glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  if (!complete)
+    destroy();
+  return complete;
+}
+
+void RenderTarget::blitToScreen(int screenW, int screenH) const {
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+  glBlitFramebuffer(0, 0, width, height, 0, 0, screenW, screenH,
+                    GL_COLOR_BUFFER_BIT, GL_LINEAR);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void RenderTarget::destroy() {
+  if (fbo)
+    glDeleteFramebuffers(1, &fbo);
+  if (colorTexture)
+    glDeleteTextures(1, &colorTexture);
+  if (depthBuffer)
+    glDeleteRenderbuffers(1, &depthBuffer);
+  fbo = colorTexture = depthBuffer = 0;
+  width = height = 0;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <GL/glew.h>
+
+// --- Adaptive Quality ---
+// The governor watches CPU update time and GPU frame time against a frame
+// budget and walks a fixed ladder of quality levels. Level 0 is full quality;
+// every step down trades image quality for frame time.
+struct QualitySettings {
+  int particleBudget;  // Max live firework particles
+  float cullPixelSize; // Drones projected smaller than this (px) are skipped
+  float mipBias;       // Added to the drone sprite mip level
+  float renderScale;   // Offscreen render resolution relative to the window
+};
+
+struct QualityGovernor {
+  bool enabled = true;
+  float targetFrameMs = 16.6f;
+  int level = 0;
+
+  // Exponentially smoothed measurements
+  float cpuMs = 0.0f, gpuMs = 0.0f;
+
+  // Hysteresis state
+  int overBudgetFrames = 0, underBudgetFrames = 0, cooldownFrames = 0;
+  const char *lastDecision = "Start at full quality";
+
+  void update(float cpuFrameMs, float gpuFrameMs);
+  const QualitySettings &settings() const;
+  static int levelCount();
+};
+
+// Measures GPU time of a frame with GL_TIME_ELAPSED queries. Several queries
+// are kept in flight so reading a result never stalls the pipeline; the
+// reported time therefore lags a couple of frames behind.
+struct GpuTimer {
+  static const int QUERY_COUNT = 4;
+  GLuint queries[QUERY_COUNT] = {0};
+  int writeIndex = 0, pending = 0;
+  float lastMs = 0.0f;
+
+  void init();
+  void begin();
+  void end();
+  void destroy();
+};
+
+// Offscreen color + depth target the scene is drawn into when the governor
+// lowers the render resolution. It is upscaled to the window with a blit.
+struct RenderTarget {
+  GLuint fbo = 0, colorTexture = 0, depthBuffer = 0;
+  int width = 0, height = 0;
+
+  // (Re)creates the attachments when the requested size changes.
+  bool resize(int w, int h);
+  void blitToScreen(int screenW, int screenH) const;
+  void destroy();
+};
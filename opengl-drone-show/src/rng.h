@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+// --- Deterministic RNG (SplitMix64) ---
+// Small, fast and identical on every platform, so a seed reproduces the
+// same show, import or generated file everywhere.
+struct Rng {
+  uint64_t state;
+  explicit Rng(uint64_t seed = 0) : state(seed) {}
+  uint64_t next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+  }
+  float uniform() { return (next() >> 40) / 16777216.0f; } // [0, 1)
+  float range(float lo, float hi) { return lo + (hi - lo) * uniform(); }
+  uint32_t below(uint32_t n) { return (uint32_t)((next() >> 32) * n >> 32); }
+};
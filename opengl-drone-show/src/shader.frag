@@ -10,11 +10,13 @@ in vec2 fTexCoords;
 
 // 사용할 텍스처(드론 이미지)
 uniform sampler2D droneTexture;
+// 품질 조절기가 정하는 밉 바이어스(클수록 흐리지만 샘플링 비용이 적음)
+uniform float mipBias;
 
 void main()
 {
     // 텍스처에서 해당 좌표의 색상 값을 샘플링
-    vec4 texColor = texture(droneTexture, fTexCoords);
+    vec4 texColor = texture(droneTexture, fTexCoords, mipBias);
 
     // 텍스처의 알파 값이 낮으면(투명한 부분이면) 픽셀을 그리지 않음
     if (texColor.a < 0.1)
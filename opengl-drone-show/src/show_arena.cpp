@@ -0,0 +1,25 @@
+#include "show_arena.h"
+
+ShowArena::ShowArena() { resource.emplace(std::pmr::new_delete_resource()); }
+
+void ShowArena::release() {
+  resource->release();
+  used = 0;
+}
+
+void ShowArena::reserve(size_t bytes) {
+  if (bytes > blockSize) {
+    // Drop the old block before allocating the new one to keep the peak down
+    resource.emplace(std::pmr::new_delete_resource());
+    block.reset();
+    block.reset(new unsigned char[bytes]);
+    blockSize = bytes;
+  }
+  resource.emplace(block.get(), blockSize, std::pmr::new_delete_resource());
+  used = 0;
+}
+
+void *ShowArena::do_allocate(size_t bytes, size_t alignment) {
+  used += bytes;
+  return resource->allocate(bytes, alignment);
+}
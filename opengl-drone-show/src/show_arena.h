@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+// --- Show Arena ---
+// One block of memory for everything a loaded show owns: title, layer names
+// and formation points. Allocating is a pointer bump, nothing is freed on its
+// own, and release() drops the whole show at once before the next load. The
+// block is sized from a pre-scan of the show file; anything past it (layers
+// imported later, say) comes from the heap and is released with the rest.
+struct ShowArena : std::pmr::memory_resource {
+  ShowArena();
+
+  // Frees everything allocated from the arena. Every object using it must
+  // be gone or emptied first. The block is kept for the next show.
+  void release();
+  // Grows the block to at least `bytes` if needed. Call right after
+  // release(), before the first allocation of the new show.
+  void reserve(size_t bytes);
+
+  size_t capacity() const { return blockSize; }
+  size_t usedBytes() const { return used; } // Including heap fallback
+
+private:
+  std::unique_ptr<unsigned char[]> block;
+  size_t blockSize = 0, used = 0;
+  std::optional<std::pmr::monotonic_buffer_resource> resource;
+
+  void *do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void *, size_t, size_t) override {}
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+};
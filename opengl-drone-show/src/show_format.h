@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+// --- Binary Show Format (.dshow) ---
+// Compact alternative to the JSON show file for very large shows. All values
+// are little-endian and tightly packed:
+//
+//   ShowFileHeader
+//   char title[titleLength]
+//   repeated layerCount times:
+//     ShowLayerHeader
+//     char id[idLength]
+//     char name[nameLength]
+//     ShowPointRecord points[pointCount]
+const char SHOW_FILE_MAGIC[4] = {'D', 'S', 'H', 'W'};
+const uint32_t SHOW_FILE_VERSION = 1;
+
+#pragma pack(push, 1)
+struct ShowFileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t layerCount;
+  uint32_t titleLength;
+};
+struct ShowLayerHeader {
+  uint32_t idLength;
+  uint32_t nameLength;
+  int32_t duration; // Milliseconds
+  uint32_t pointCount;
+};
+struct ShowPointRecord {
+  float x, y, z;
+  uint8_t r, g, b, a;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(ShowFileHeader) == 16, "unexpected header padding");
+static_assert(sizeof(ShowLayerHeader) == 16, "unexpected header padding");
+static_assert(sizeof(ShowPointRecord) == 16, "unexpected point padding");
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "vec_math.h"
+
+// --- Data Structures ---
+// Shows use polymorphic allocators so a loaded show can live in one
+// ShowArena (see show_arena.h). Layers built elsewhere, such as imported
+// images, use the default heap and are copied into the arena when appended.
+struct DronePoint {
+  Vec3 pos;
+  Vec4 color;
+};
+static_assert(sizeof(DronePoint) == 28, "DronePoint is stored by the million");
+struct DroneLayer {
+  using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+  std::pmr::string id;
+  std::pmr::string name;
+  int duration = 0;
+  std::pmr::vector<DronePoint> points;
+
+  DroneLayer() = default;
+  DroneLayer(const DroneLayer &) = default;
+  DroneLayer(DroneLayer &&) = default;
+  DroneLayer &operator=(const DroneLayer &) = default;
+  DroneLayer &operator=(DroneLayer &&) = default;
+
+  // Allocator-extended constructors, used when a layer is placed in a
+  // std::pmr::vector so its strings and points share the vector's resource.
+  explicit DroneLayer(const allocator_type &alloc)
+      : id(alloc), name(alloc), points(alloc) {}
+  DroneLayer(const DroneLayer &other, const allocator_type &alloc)
+      : id(other.id, alloc), name(other.name, alloc),
+        duration(other.duration), points(other.points, alloc) {}
+  DroneLayer(DroneLayer &&other, const allocator_type &alloc)
+      : id(std::move(other.id), alloc), name(std::move(other.name), alloc),
+        duration(other.duration), points(std::move(other.points), alloc) {}
+};
+struct DroneShow {
+  std::pmr::string title;
+  std::pmr::vector<DroneLayer> layers;
+};
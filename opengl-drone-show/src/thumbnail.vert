@@ -0,0 +1,14 @@
+#version 330 core
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec4 aColor;
+
+// Front view of one layer fitted into its atlas tile (see thumbnailFrame)
+uniform vec2 center;
+uniform float scale; // World units to clip space
+
+out vec4 vColor;
+
+void main() {
+  gl_Position = vec4((aPos.xy - center) * scale, 0.0, 1.0);
+  vColor = aColor;
+}
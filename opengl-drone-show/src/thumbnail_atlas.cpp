@@ -0,0 +1,258 @@
+#define GLEW_STATIC
+#include "thumbnail_atlas.h"
+
+#include <algorithm>
+#include <cstdio>
+
+static const int THUMBNAIL_MARGIN = 4;  // Pixels left free around the shape
+static const float THUMBNAIL_POINT = 2; // Point edge in pixels
+static const unsigned char BACKGROUND[4] = {20, 20, 26, 255};
+
+ThumbnailFrame thumbnailFrame(const DroneLayer &layer) {
+  ThumbnailFrame frame;
+  if (layer.points.empty())
+    return frame;
+  float minX = layer.points[0].pos.x, maxX = minX;
+  float minY = layer.points[0].pos.y, maxY = minY;
+  for (const DronePoint &p : layer.points) {
+    minX = std::min(minX, p.pos.x);
+    maxX = std::max(maxX, p.pos.x);
+    minY = std::min(minY, p.pos.y);
+    maxY = std::max(maxY, p.pos.y);
+  }
+  frame.centerX = (minX + maxX) * 0.5f;
+  frame.centerY = (minY + maxY) * 0.5f;
+  float extent = std::max(std::max(maxX - minX, maxY - minY), 1.0f);
+  frame.scale = (THUMBNAIL_SIZE - 2 * THUMBNAIL_MARGIN) / extent;
+  return frame;
+}
+
+void rasterizeThumbnail(const DroneLayer &layer, unsigned char *tile,
+                        size_t stride) {
+  for (int y = 0; y < THUMBNAIL_SIZE; ++y)
+    for (int x = 0; x < THUMBNAIL_SIZE; ++x)
+      std::copy_n(BACKGROUND, 4, tile + y * stride + x * 4);
+
+  // Same result as the GL path: square points blended in show order
+  ThumbnailFrame frame = thumbnailFrame(layer);
+  const float half = THUMBNAIL_SIZE * 0.5f, radius = THUMBNAIL_POINT * 0.5f;
+  for (const DronePoint &p : layer.points) {
+    float alpha = std::min(std::max(p.color.w, 0.0f), 1.0f);
+    if (alpha <= 0.0f)
+      continue;
+    float px = (p.pos.x - frame.centerX) * frame.scale + half;
+    float py = (p.pos.y - frame.centerY) * frame.scale + half;
+    int x0 = std::max((int)(px - radius + 0.5f), 0);
+    int y0 = std::max((int)(py - radius + 0.5f), 0);
+    int x1 = std::min((int)(px + radius + 0.5f), THUMBNAIL_SIZE);
+    int y1 = std::min((int)(py + radius + 0.5f), THUMBNAIL_SIZE);
+    const float color[3] = {p.color.x, p.color.y, p.color.z};
+    for (int y = y0; y < y1; ++y) {
+      for (int x = x0; x < x1; ++x) {
+        unsigned char *dst = tile + y * stride + x * 4;
+        for (int c = 0; c < 3; ++c) {
+          float src = std::min(std::max(color[c], 0.0f), 1.0f) * 255.0f;
+          dst[c] = (unsigned char)(src * alpha + dst[c] * (1.0f - alpha) +
+                                   0.5f);
+        }
+      }
+    }
+  }
+}
+
+bool writeThumbnailSheet(const std::pmr::vector<DroneLayer> &layers,
+                         const char *path, std::string &error) {
+  if (layers.empty()) {
+    error = "the show has no layers";
+    return false;
+  }
+  int columns = std::min((int)layers.size(), THUMBNAIL_COLUMNS);
+  int rows = ((int)layers.size() + THUMBNAIL_COLUMNS - 1) / THUMBNAIL_COLUMNS;
+  int width = columns * THUMBNAIL_SIZE, height = rows * THUMBNAIL_SIZE;
+  size_t stride = (size_t)width * 4;
+  std::vector<unsigned char> sheet(stride * height, 0);
+  for (size_t i = 0; i < layers.size(); ++i) {
+    int x = (int)(i % THUMBNAIL_COLUMNS) * THUMBNAIL_SIZE;
+    int y = (int)(i / THUMBNAIL_COLUMNS) * THUMBNAIL_SIZE;
+    rasterizeThumbnail(layers[i], sheet.data() + y * stride + x * 4, stride);
+  }
+
+  FILE *file = fopen(path, "wb");
+  if (!file) {
+    error = "cannot open for writing";
+    return false;
+  }
+  // Tiles are stored bottom row first; PPM starts at the top. Each tile
+  // row becomes its own band, so the sheet reads left to right, top down.
+  fprintf(file, "P6\n%d %d\n255\n", width, height);
+  std::vector<unsigned char> line((size_t)width * 3);
+  for (int band = 0; band < rows; ++band) {
+    for (int y = THUMBNAIL_SIZE - 1; y >= 0; --y) {
+      const unsigned char *src =
+          sheet.data() + ((size_t)band * THUMBNAIL_SIZE + y) * stride;
+      for (int x = 0; x < width; ++x)
+        std::copy_n(src + x * 4, 3, line.data() + x * 3);
+      fwrite(line.data(), 1, line.size(), file);
+    }
+  }
+  bool ok = !ferror(file);
+  if (fclose(file) != 0 || !ok) {
+    error = "write failed";
+    return false;
+  }
+  return true;
+}
+
+void ThumbnailAtlas::init() {
+  GLint size = 0;
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &size);
+  maxTextureSize = size;
+}
+
+void ThumbnailAtlas::sync(size_t layerCount, unsigned int showRevision) {
+  if (showRevision != revision) {
+    revision = showRevision;
+    stale.clear();
+  }
+  if (layerCount < stale.size())
+    stale.resize(layerCount);
+
+  int rows = ((int)layerCount + THUMBNAIL_COLUMNS - 1) / THUMBNAIL_COLUMNS;
+  rows = std::min(std::max(rows, 1),
+                  std::max(maxTextureSize / THUMBNAIL_SIZE, 1));
+  if (rows * THUMBNAIL_SIZE > atlasHeight) {
+    // A taller texture starts out empty, so every tile is drawn again
+    destroy();
+    atlasWidth = THUMBNAIL_COLUMNS * THUMBNAIL_SIZE;
+    atlasHeight = rows * THUMBNAIL_SIZE;
+    glGenTextures(1, &atlasTexture);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, atlasWidth, atlasHeight, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                           GL_TEXTURE_2D, atlasTexture, 0);
+    fboComplete =
+        glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(DronePoint),
+                          (void *)offsetof(DronePoint, pos));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(DronePoint),
+                          (void *)offsetof(DronePoint, color));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+    stale.clear();
+  }
+
+  // Layers past the largest atlas the driver allows get no tile
+  size_t capacity = (size_t)(atlasHeight / THUMBNAIL_SIZE) * THUMBNAIL_COLUMNS;
+  stale.resize(std::min(layerCount, capacity), 1);
+  pending = (int)std::count(stale.begin(), stale.end(), 1);
+}
+
+void ThumbnailAtlas::update(const std::pmr::vector<DroneLayer> &layers,
+                            GLuint program) {
+  if (pending == 0 || !atlasTexture)
+    return;
+  if (fboComplete) {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_SCISSOR_TEST);
+    glUseProgram(program);
+    glPointSize(THUMBNAIL_POINT);
+    // Blend color as in the scene but keep the tile opaque
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
+                        GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glClearColor(BACKGROUND[0] / 255.0f, BACKGROUND[1] / 255.0f,
+                 BACKGROUND[2] / 255.0f, 1.0f);
+  } else {
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    tilePixels.resize((size_t)THUMBNAIL_SIZE * THUMBNAIL_SIZE * 4);
+  }
+
+  int drawn = 0;
+  size_t points = 0;
+  for (size_t i = 0; i < stale.size() && drawn < tilesPerFrame; ++i) {
+    if (!stale[i])
+      continue;
+    const DroneLayer &layer = layers[i];
+    if (drawn > 0 && points + layer.points.size() > pointsPerFrame)
+      break;
+    points += layer.points.size();
+    int x = (int)(i % THUMBNAIL_COLUMNS) * THUMBNAIL_SIZE;
+    int y = (int)(i / THUMBNAIL_COLUMNS) * THUMBNAIL_SIZE;
+    if (fboComplete) {
+      glViewport(x, y, THUMBNAIL_SIZE, THUMBNAIL_SIZE);
+      glScissor(x, y, THUMBNAIL_SIZE, THUMBNAIL_SIZE);
+      glClear(GL_COLOR_BUFFER_BIT);
+      if (!layer.points.empty()) {
+        // Tile pixels to clip space
+        ThumbnailFrame frame = thumbnailFrame(layer);
+        glUniform2f(glGetUniformLocation(program, "center"), frame.centerX,
+                    frame.centerY);
+        glUniform1f(glGetUniformLocation(program, "scale"),
+                    frame.scale * 2.0f / THUMBNAIL_SIZE);
+        glBufferData(GL_ARRAY_BUFFER, layer.points.size() * sizeof(DronePoint),
+                     layer.points.data(), GL_STREAM_DRAW);
+        glDrawArrays(GL_POINTS, 0, (GLsizei)layer.points.size());
+      }
+    } else {
+      rasterizeThumbnail(layer, tilePixels.data(), THUMBNAIL_SIZE * 4);
+      glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, THUMBNAIL_SIZE, THUMBNAIL_SIZE,
+                      GL_RGBA, GL_UNSIGNED_BYTE, tilePixels.data());
+    }
+    stale[i] = 0;
+    --pending;
+    ++drawn;
+  }
+
+  if (fboComplete) {
+    glDisable(GL_SCISSOR_TEST);
+    glEnable(GL_DEPTH_TEST);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  }
+}
+
+void ThumbnailAtlas::tileUV(size_t layer, float &u0, float &v0, float &u1,
+                            float &v1) const {
+  float w = (float)THUMBNAIL_SIZE / atlasWidth;
+  float h = (float)THUMBNAIL_SIZE / atlasHeight;
+  u0 = (layer % THUMBNAIL_COLUMNS) * w;
+  u1 = u0 + w;
+  // GL rows run bottom up, so the top edge has the larger v
+  v1 = (layer / THUMBNAIL_COLUMNS) * h;
+  v0 = v1 + h;
+}
+
+void ThumbnailAtlas::destroy() {
+  if (fbo)
+    glDeleteFramebuffers(1, &fbo);
+  if (atlasTexture)
+    glDeleteTextures(1, &atlasTexture);
+  if (vao)
+    glDeleteVertexArrays(1, &vao);
+  if (vbo)
+    glDeleteBuffers(1, &vbo);
+  fbo = atlasTexture = vao = vbo = 0;
+  atlasWidth = atlasHeight = 0;
+  fboComplete = false;
+  stale.clear();
+  pending = 0;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "show_types.h"
+
+// --- Layer Thumbnails ---
+// A small front-view picture of every layer (x right, y up), packed as tiles
+// into one atlas texture that the timeline strip and the layer tooltips draw
+// from. Tiles are rendered a few per frame through an FBO and only again
+// when their layer changes, so showing them costs nothing but the quads.
+// rasterizeThumbnail() is the CPU path: it fills tiles when the FBO is not
+// available and builds the headless contact sheet (--thumbnails).
+const int THUMBNAIL_SIZE = 64;    // Tile edge in pixels
+const int THUMBNAIL_COLUMNS = 16; // Tiles per atlas row
+
+// Maps a layer into its tile: pixel = (pos.xy - center) * scale + SIZE / 2.
+struct ThumbnailFrame {
+  float centerX = 0.0f, centerY = 0.0f;
+  float scale = 1.0f;
+};
+ThumbnailFrame thumbnailFrame(const DroneLayer &layer);
+
+// Draws the layer into a THUMBNAIL_SIZE square RGBA8 tile whose rows are
+// `stride` bytes apart, bottom row first like a GL texture.
+void rasterizeThumbnail(const DroneLayer &layer, unsigned char *tile,
+                        size_t stride);
+
+// Writes every layer's tile into one binary PPM laid out like the atlas.
+// On failure returns false and describes the problem in `error`.
+bool writeThumbnailSheet(const std::pmr::vector<DroneLayer> &layers,
+                         const char *path, std::string &error);
+
+struct ThumbnailAtlas {
+  // Work per update(): stops at either limit, but always draws one tile
+  int tilesPerFrame = 4;
+  size_t pointsPerFrame = 200000;
+
+  // Reads the driver limits; call once after the GL context exists.
+  void init();
+  // Marks tiles stale: all of them when `showRevision` changed (another
+  // show was loaded), otherwise only those of layers added since the last
+  // call. Grows the atlas when the layers no longer fit.
+  void sync(size_t layerCount, unsigned int showRevision);
+  // Renders the next stale tiles with `program` (thumbnail.vert/.frag).
+  // Leaves the default framebuffer bound, depth testing on and the scene's
+  // blend function; the caller sets its viewport again.
+  void update(const std::pmr::vector<DroneLayer> &layers, GLuint program);
+  void destroy();
+
+  bool ready(size_t layer) const {
+    return layer < stale.size() && !stale[layer];
+  }
+  // Texture coordinates of a tile's top-left and bottom-right corners
+  void tileUV(size_t layer, float &u0, float &v0, float &u1,
+              float &v1) const;
+  GLuint texture() const { return atlasTexture; }
+  int pendingTiles() const { return pending; }
+  size_t atlasBytes() const { return (size_t)atlasWidth * atlasHeight * 4; }
+
+private:
+  GLuint fbo = 0, atlasTexture = 0;
+  GLuint vao = 0, vbo = 0;
+  int atlasWidth = 0, atlasHeight = 0;
+  int maxTextureSize = 0; // GL_MAX_TEXTURE_SIZE, read by init()
+  bool fboComplete = false;
+  std::vector<unsigned char> stale; // Per layer, 1 until its tile is drawn
+  int pending = 0;
+  unsigned int revision = 0;
+  std::vector<unsigned char> tilePixels; // CPU fallback upload
+};
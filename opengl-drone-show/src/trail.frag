@@ -0,0 +1,12 @@
+#version 330 core
+
+out vec4 FragColor;
+
+in vec4 vColor;
+
+void main()
+{
+    if (vColor.a < 0.01)
+        discard;
+    FragColor = vColor;
+}
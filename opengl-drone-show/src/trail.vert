@@ -0,0 +1,50 @@
+#version 330 core
+
+// Motion trails: one instance per slot, one line segment per pair of
+// neighbouring samples, read from the ring buffer kept by MotionTrails.
+layout (std140) uniform ViewBlock {
+    mat4 viewProjection;
+    vec4 cameraRight;
+    vec4 cameraUp;
+    vec4 cullParams;
+};
+
+// Row r of the ring holds every slot's position at r (w = alpha, 0 = unused)
+uniform samplerBuffer trailPositions;
+// Current color of every slot
+uniform samplerBuffer trailColors;
+uniform int slotCount;
+uniform int ringLength;
+uniform int head;        // Row of the newest sample
+uniform int sampleCount; // Valid rows
+uniform float fade;      // Fade exponent toward the tail
+
+out vec4 vColor;
+
+vec4 fetchSample(int age)
+{
+    int row = (head - age + ringLength) % ringLength;
+    return texelFetch(trailPositions, row * slotCount + gl_InstanceID);
+}
+
+void main()
+{
+    int segment = gl_VertexID / 2;
+    int age = segment + gl_VertexID % 2; // 0 = newest
+    vec4 newer = fetchSample(segment);
+    vec4 older = fetchSample(segment + 1);
+
+    // A segment touching an unused sample (hidden drone, dead spark) is
+    // dropped by moving both of its vertices outside the clip volume
+    if (newer.w <= 0.0 || older.w <= 0.0) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        vColor = vec4(0.0);
+        return;
+    }
+
+    vec4 p = gl_VertexID % 2 == 0 ? newer : older;
+    float tail = 1.0 - float(age) / float(sampleCount);
+    vColor = vec4(texelFetch(trailColors, gl_InstanceID).rgb,
+                  p.w * pow(tail, fade));
+    gl_Position = viewProjection * vec4(p.xyz, 1.0);
+}
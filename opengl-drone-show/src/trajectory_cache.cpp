@@ -0,0 +1,620 @@
+#include "trajectory_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+
+static const size_t LZ_MIN_MATCH = 4;
+static const size_t LZ_MAX_OFFSET = 65535;
+static const int LZ_HASH_BITS = 16;
+static const size_t MAX_VARINT_BYTES = 10;
+static const int HUFFMAN_MAX_BITS = 12;
+// First byte of a frame block
+enum BlockCoding : uint8_t { BLOCK_LZ = 0, BLOCK_LZ_HUFFMAN = 1 };
+
+// --- Varints ---
+static void putVarint(uint8_t *&out, uint64_t value) {
+  while (value >= 0x80) {
+    *out++ = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  *out++ = (uint8_t)value;
+}
+// Largest raw frame for `droneCount` drones: a varint per position axis and
+// a byte per color channel.
+static size_t maxRawFrameSize(size_t droneCount) {
+  return droneCount * (3 * MAX_VARINT_BYTES + 4);
+}
+
+// Bound on lzCompress output for `size` input bytes. Every match saves at
+// least its own token and offset, so only the literal runs add overhead.
+static size_t lzBound(size_t size) { return size + size / 64 + 64; }
+
+static bool getVarint(const uint8_t *&in, const uint8_t *end,
+                      uint64_t &value) {
+  value = 0;
+  for (int shift = 0; shift < 64 && in < end; shift += 7) {
+    uint8_t byte = *in++;
+    value |= (uint64_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+static uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (v >> 63); }
+static int64_t unzigzag(uint64_t v) {
+  return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+// --- LZ Coder ---
+// Sequence layout: token (literal count << 4 | match length - 4, each
+// saturating at 15 with the rest in a varint), literals, 16-bit offset and
+// the match length varint. The last sequence has literals only.
+static void lzEmit(std::vector<uint8_t> &out, const uint8_t *literals,
+                   size_t literalCount, size_t matchLength, size_t offset) {
+  uint8_t varint[MAX_VARINT_BYTES], *end;
+  size_t matchCode = matchLength ? matchLength - LZ_MIN_MATCH : 0;
+  out.push_back((uint8_t)(std::min(literalCount, (size_t)15) << 4 |
+                          std::min(matchCode, (size_t)15)));
+  if (literalCount >= 15) {
+    end = varint;
+    putVarint(end, literalCount - 15);
+    out.insert(out.end(), varint, end);
+  }
+  out.insert(out.end(), literals, literals + literalCount);
+  if (!matchLength)
+    return;
+  out.push_back((uint8_t)(offset & 0xFF));
+  out.push_back((uint8_t)(offset >> 8));
+  if (matchCode >= 15) {
+    end = varint;
+    putVarint(end, matchCode - 15);
+    out.insert(out.end(), varint, end);
+  }
+}
+
+void lzCompress(const uint8_t *src, size_t size, std::vector<uint8_t> &out) {
+  out.clear();
+  // Reused across frames; only its contents are reset
+  static thread_local std::vector<int64_t> table((size_t)1 << LZ_HASH_BITS);
+  std::fill(table.begin(), table.end(), -1);
+  size_t anchor = 0, i = 0;
+  while (i + LZ_MIN_MATCH <= size) {
+    uint32_t sequence;
+    memcpy(&sequence, src + i, sizeof(sequence));
+    uint32_t hash = (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+    int64_t candidate = table[hash];
+    table[hash] = (int64_t)i;
+    if (candidate < 0 || i - candidate > LZ_MAX_OFFSET ||
+        memcmp(src + candidate, src + i, LZ_MIN_MATCH) != 0) {
+      ++i;
+      continue;
+    }
+    size_t length = LZ_MIN_MATCH;
+    while (i + length < size && src[candidate + length] == src[i + length])
+      ++length;
+    lzEmit(out, src + anchor, i - anchor, length, i - candidate);
+    i += length;
+    anchor = i;
+  }
+  lzEmit(out, src + anchor, size - anchor, 0, 0);
+}
+
+bool lzDecompress(const uint8_t *src, size_t size, uint8_t *dst,
+                  size_t dstSize) {
+  const uint8_t *in = src, *inEnd = src + size;
+  uint8_t *out = dst, *outEnd = dst + dstSize;
+  while (in < inEnd) {
+    uint8_t token = *in++;
+    uint64_t extra;
+    size_t literals = token >> 4;
+    if (literals == 15) {
+      if (!getVarint(in, inEnd, extra))
+        return false;
+      literals += extra;
+    }
+    if (literals > (size_t)(inEnd - in) || literals > (size_t)(outEnd - out))
+      return false;
+    memcpy(out, in, literals);
+    out += literals;
+    in += literals;
+    if (in == inEnd)
+      break; // Last sequence
+
+    if (inEnd - in < 2)
+      return false;
+    size_t offset = in[0] | (size_t)in[1] << 8;
+    in += 2;
+    size_t length = (token & 15) + LZ_MIN_MATCH;
+    if ((token & 15) == 15) {
+      if (!getVarint(in, inEnd, extra))
+        return false;
+      length += extra;
+    }
+    if (offset == 0 || offset > (size_t)(out - dst) ||
+        length > (size_t)(outEnd - out))
+      return false;
+    const uint8_t *match = out - offset;
+    if (offset >= length)
+      memcpy(out, match, length);
+    else if (offset == 1)
+      memset(out, *match, length);
+    else
+      for (size_t k = 0; k < length; ++k) // Overlapping repeat
+        out[k] = match[k];
+    out += length;
+  }
+  return out == outEnd;
+}
+
+// --- Huffman Coder ---
+// Order-0 canonical Huffman over bytes, codes limited to HUFFMAN_MAX_BITS.
+// Layout: varint byte count, 128 bytes of 4-bit code lengths, then the codes
+// packed least significant bit first.
+static void huffmanCodeLengths(const uint64_t counts[256], uint8_t lengths[256]) {
+  struct Node {
+    uint64_t count;
+    int left, right;
+  };
+  std::vector<Node> nodes;
+  typedef std::pair<uint64_t, int> Entry; // count, node
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+  for (int b = 0; b < 256; ++b) {
+    lengths[b] = 0;
+    if (counts[b]) {
+      heap.push({counts[b], (int)nodes.size()});
+      nodes.push_back({counts[b], -1, b});
+    }
+  }
+  if (nodes.size() == 1) {
+    lengths[nodes[0].right] = 1;
+    return;
+  }
+  while (heap.size() > 1) {
+    Entry a = heap.top();
+    heap.pop();
+    Entry b = heap.top();
+    heap.pop();
+    heap.push({a.first + b.first, (int)nodes.size()});
+    nodes.push_back({a.first + b.first, a.second, b.second});
+  }
+  // Depth of every leaf; leaves keep their byte in `right`
+  std::vector<std::pair<int, int>> stack = {{(int)nodes.size() - 1, 0}};
+  while (!stack.empty()) {
+    std::pair<int, int> top = stack.back();
+    stack.pop_back();
+    const Node &node = nodes[top.first];
+    if (node.left < 0) {
+      lengths[node.right] = (uint8_t)std::min(top.second, HUFFMAN_MAX_BITS);
+    } else {
+      stack.push_back({node.left, top.second + 1});
+      stack.push_back({node.right, top.second + 1});
+    }
+  }
+  // Clamping may have overfilled the code space; lengthen the longest codes
+  // that still can be until the Kraft sum fits again.
+  int64_t kraft = 0;
+  for (int b = 0; b < 256; ++b)
+    if (lengths[b])
+      kraft += (int64_t)1 << (HUFFMAN_MAX_BITS - lengths[b]);
+  while (kraft > ((int64_t)1 << HUFFMAN_MAX_BITS)) {
+    int best = -1;
+    for (int b = 0; b < 256; ++b)
+      if (lengths[b] && lengths[b] < HUFFMAN_MAX_BITS &&
+          (best < 0 || lengths[b] > lengths[best]))
+        best = b;
+    kraft -= (int64_t)1 << (HUFFMAN_MAX_BITS - lengths[best] - 1);
+    ++lengths[best];
+  }
+}
+
+// Canonical codes, bit-reversed for least-significant-bit-first output.
+static void huffmanCodes(const uint8_t lengths[256], uint16_t codes[256]) {
+  int lengthCount[HUFFMAN_MAX_BITS + 1] = {0};
+  for (int b = 0; b < 256; ++b)
+    ++lengthCount[lengths[b]];
+  lengthCount[0] = 0;
+  int next[HUFFMAN_MAX_BITS + 2] = {0};
+  for (int bits = 1, code = 0; bits <= HUFFMAN_MAX_BITS; ++bits) {
+    code = (code + lengthCount[bits - 1]) << 1;
+    next[bits] = code;
+  }
+  for (int b = 0; b < 256; ++b) {
+    codes[b] = 0;
+    if (!lengths[b])
+      continue;
+    int code = next[lengths[b]]++;
+    for (int k = 0; k < lengths[b]; ++k)
+      codes[b] |= ((code >> k) & 1) << (lengths[b] - 1 - k);
+  }
+}
+
+static void huffmanCompress(const uint8_t *src, size_t size,
+                            std::vector<uint8_t> &out) {
+  uint64_t counts[256] = {0};
+  for (size_t i = 0; i < size; ++i)
+    ++counts[src[i]];
+  uint8_t lengths[256];
+  uint16_t codes[256];
+  huffmanCodeLengths(counts, lengths);
+  huffmanCodes(lengths, codes);
+
+  out.resize(MAX_VARINT_BYTES + 128 + size * HUFFMAN_MAX_BITS / 8 + 8);
+  uint8_t *o = out.data();
+  putVarint(o, size);
+  for (int b = 0; b < 256; b += 2)
+    *o++ = (uint8_t)(lengths[b] | lengths[b + 1] << 4);
+  uint64_t bits = 0;
+  int bitCount = 0;
+  for (size_t i = 0; i < size; ++i) {
+    bits |= (uint64_t)codes[src[i]] << bitCount;
+    bitCount += lengths[src[i]];
+    while (bitCount >= 8) {
+      *o++ = (uint8_t)bits;
+      bits >>= 8;
+      bitCount -= 8;
+    }
+  }
+  if (bitCount)
+    *o++ = (uint8_t)bits;
+  out.resize(o - out.data());
+}
+
+// Rejects streams that claim more than `maxCount` symbols, so a corrupt
+// count cannot force an allocation.
+static bool huffmanDecompress(const uint8_t *src, size_t size,
+                              size_t maxCount, std::vector<uint8_t> &out) {
+  const uint8_t *in = src, *end = src + size;
+  uint64_t count;
+  if (!getVarint(in, end, count) || count > maxCount || end - in < 128)
+    return false;
+  uint8_t lengths[256];
+  for (int b = 0; b < 256; b += 2) {
+    lengths[b] = *in & 15;
+    lengths[b + 1] = *in++ >> 4;
+  }
+  uint16_t codes[256];
+  huffmanCodes(lengths, codes);
+  // One entry per HUFFMAN_MAX_BITS-bit window: symbol and code length
+  static thread_local uint16_t table[1 << HUFFMAN_MAX_BITS];
+  memset(table, 0, sizeof(table));
+  for (int b = 0; b < 256; ++b) {
+    if (!lengths[b])
+      continue;
+    for (int fill = codes[b]; fill < (1 << HUFFMAN_MAX_BITS);
+         fill += 1 << lengths[b])
+      table[fill] = (uint16_t)(b | lengths[b] << 8);
+  }
+
+  out.resize(count);
+  uint64_t bits = 0;
+  int bitCount = 0;
+  for (uint64_t i = 0; i < count; ++i) {
+    while (bitCount <= 56) {
+      bits |= (uint64_t)(in < end ? *in++ : 0) << bitCount;
+      bitCount += 8;
+    }
+    uint16_t entry = table[bits & ((1 << HUFFMAN_MAX_BITS) - 1)];
+    int length = entry >> 8;
+    if (!length)
+      return false;
+    out[i] = (uint8_t)entry;
+    bits >>= length;
+    bitCount -= length;
+  }
+  return true;
+}
+
+// --- Prediction ---
+// Positions are extrapolated from up to three earlier frames, as many as
+// have been decoded since the last keyframe.
+static int predictionOrder(uint32_t frame, uint32_t keyframeInterval) {
+  return (int)std::min(frame % keyframeInterval, 3u);
+}
+static int64_t predict(int order, int64_t p1, int64_t p2, int64_t p3) {
+  switch (order) {
+  case 0:
+    return 0;
+  case 1:
+    return p1; // Hold position
+  case 2:
+    return 2 * p1 - p2; // Constant velocity
+  default:
+    return 3 * p1 - 3 * p2 + p3; // Constant acceleration
+  }
+}
+// Makes the slot just written (history[2]) the newest frame.
+static void rotateHistory(std::vector<int32_t> history[3]) {
+  history[2].swap(history[1]);
+  history[1].swap(history[0]);
+}
+
+// --- Encoder ---
+bool TrajectoryEncoder::open(const char *path, const DroneShow &show,
+                             int droneCount, float frameRate,
+                             int keyframeInterval, float positionStep) {
+  if (droneCount <= 0 || (uint32_t)droneCount > BAKE_MAX_DRONE_COUNT)
+    return false;
+  file.open(path, std::ios::binary | std::ios::trunc);
+  if (!file)
+    return false;
+  memcpy(header.magic, BAKE_FILE_MAGIC, 4);
+  header.version = BAKE_FILE_VERSION;
+  header.droneCount = droneCount;
+  header.keyframeInterval = std::max(1, keyframeInterval);
+  header.frameRate = frameRate;
+  header.positionStep = positionStep;
+  header.layerCount = show.layers.size();
+  header.titleLength = show.title.size();
+  file.write((const char *)&header, sizeof(header));
+  file.write(show.title.data(), show.title.size());
+  for (const auto &l : show.layers) {
+    BakeLayerHeader layerHeader = {(uint32_t)l.name.size(), l.duration};
+    file.write((const char *)&layerHeader, sizeof(layerHeader));
+    file.write(l.name.data(), l.name.size());
+  }
+  for (auto &h : history)
+    h.assign((size_t)droneCount * 3, 0);
+  previousColors.assign((size_t)droneCount * 4, 0);
+  index.clear();
+  rawBytes = 0;
+  return (bool)file;
+}
+
+void TrajectoryEncoder::addFrame(const std::vector<DronePoint> &drones,
+                                 int layer, int visibleDrones) {
+  size_t n = header.droneCount;
+  uint32_t frame = index.size();
+  int order = predictionOrder(frame, header.keyframeInterval);
+  float scale = 1.0f / header.positionStep;
+  // Keep quantized values well inside int32 so predictions cannot overflow
+  const float LIMIT = 1 << 30;
+
+  raw.resize(maxRawFrameSize(n));
+  uint8_t *out = raw.data();
+  for (int axis = 0; axis < 3; ++axis) {
+    const int32_t *p1 = &history[0][axis * n], *p2 = &history[1][axis * n];
+    int32_t *p3 = &history[2][axis * n];
+    for (size_t i = 0; i < n; ++i) {
+      const Vec3 &p = drones[i].pos;
+      float v = axis == 0 ? p.x : axis == 1 ? p.y : p.z;
+      int32_t q = (int32_t)std::lround(
+          std::min(std::max(v * scale, -LIMIT), LIMIT));
+      putVarint(out, zigzag(q - predict(order, p1[i], p2[i], p3[i])));
+      p3[i] = q;
+    }
+  }
+  rotateHistory(history);
+  for (int channel = 0; channel < 4; ++channel) {
+    uint8_t *prev = &previousColors[channel * n];
+    for (size_t i = 0; i < n; ++i) {
+      const Vec4 &c = drones[i].color;
+      float v = channel == 0 ? c.x : channel == 1 ? c.y
+                : channel == 2 ? c.z : c.w;
+      uint8_t byte = (uint8_t)(std::min(std::max(v, 0.0f), 1.0f) * 255.0f +
+                               0.5f);
+      *out++ = order == 0 ? byte : (uint8_t)(byte - prev[i]);
+      prev[i] = byte;
+    }
+  }
+  raw.resize(out - raw.data());
+
+  // Entropy-code the LZ output too when that pays for the code table
+  lzCompress(raw.data(), raw.size(), lzOutput);
+  huffmanCompress(lzOutput.data(), lzOutput.size(), packed);
+  if (packed.size() < lzOutput.size()) {
+    packed.insert(packed.begin(), BLOCK_LZ_HUFFMAN);
+  } else {
+    packed.assign(1, BLOCK_LZ);
+    packed.insert(packed.end(), lzOutput.begin(), lzOutput.end());
+  }
+  BakeFrameEntry entry;
+  entry.offset = (uint64_t)file.tellp();
+  entry.compressedSize = packed.size();
+  entry.rawSize = raw.size();
+  entry.layer = layer;
+  entry.visibleDrones = visibleDrones;
+  index.push_back(entry);
+  file.write((const char *)packed.data(), packed.size());
+  rawBytes += n * (3 * sizeof(float) + 4);
+}
+
+bool TrajectoryEncoder::finish(uint32_t loopFrame) {
+  header.frameCount = index.size();
+  header.loopFrame = std::min(loopFrame, header.frameCount - 1);
+  header.indexOffset = (uint64_t)file.tellp();
+  file.write((const char *)index.data(), index.size() * sizeof(BakeFrameEntry));
+  fileBytes = (uint64_t)file.tellp();
+  file.seekp(0);
+  file.write((const char *)&header, sizeof(header));
+  file.close();
+  return !file.fail();
+}
+
+// --- Decoder ---
+bool TrajectoryDecoder::open(const char *path, std::string &error) {
+  close();
+  file.open(path, std::ios::binary | std::ios::ate);
+  uint64_t fileSize = file ? (uint64_t)file.tellg() : 0;
+  file.seekg(0);
+  if (!file.read((char *)&header, sizeof(header)) ||
+      memcmp(header.magic, BAKE_FILE_MAGIC, 4) != 0 ||
+      header.version != BAKE_FILE_VERSION || header.frameCount == 0 ||
+      header.keyframeInterval == 0 || header.positionStep <= 0.0f) {
+    error = "Not a baked trajectory file (or unsupported version)";
+    close();
+    return false;
+  }
+  auto reject = [&](const char *problem) {
+    error = std::string("Baked trajectory file ") + problem;
+    close();
+    return false;
+  };
+  // Every size in the header is checked against the file before anything is
+  // allocated from it: the title and layer table end before the frames,
+  // which end where the index starts, and the index ends the file.
+  uint64_t position = sizeof(header);
+  if (header.indexOffset < position || header.indexOffset > fileSize ||
+      (uint64_t)header.frameCount * sizeof(BakeFrameEntry) >
+          fileSize - header.indexOffset)
+    return reject("is truncated");
+  if (header.droneCount == 0 || header.droneCount > BAKE_MAX_DRONE_COUNT ||
+      header.loopFrame >= header.frameCount)
+    return reject("has a corrupt header");
+  uint64_t tableSpace = header.indexOffset - position;
+  if (header.titleLength > tableSpace ||
+      header.layerCount >
+          (tableSpace - header.titleLength) / sizeof(BakeLayerHeader))
+    return reject("has a corrupt header");
+  title.resize(header.titleLength);
+  if (!file.read(&title[0], header.titleLength))
+    return reject("is truncated");
+  position += header.titleLength;
+  for (uint32_t l = 0; l < header.layerCount; ++l) {
+    BakeLayerHeader layerHeader;
+    if (!file.read((char *)&layerHeader, sizeof(layerHeader)))
+      return reject("is truncated");
+    position += sizeof(layerHeader);
+    if (layerHeader.nameLength > header.indexOffset - position)
+      return reject("has a corrupt layer table");
+    std::string name(layerHeader.nameLength, '\0');
+    if (!file.read(&name[0], layerHeader.nameLength))
+      return reject("is truncated");
+    position += layerHeader.nameLength;
+    layerNames.push_back(name);
+    layerDurations.push_back(layerHeader.duration);
+  }
+  index.resize(header.frameCount);
+  file.seekg(header.indexOffset);
+  if (!file.read((char *)index.data(), index.size() * sizeof(BakeFrameEntry)))
+    return reject("is truncated");
+
+  // Size the frame buffers for the largest frame so playback and seeking
+  // never allocate. Every frame holds at least a byte per position axis and
+  // color channel, so an entry smaller than that, or larger than the encoder
+  // can write, means the index is corrupt.
+  size_t n = header.droneCount;
+  size_t maxCompressed = 0, maxRaw = 0;
+  for (const BakeFrameEntry &entry : index) {
+    if (entry.rawSize < n * 7 || entry.rawSize > maxRawFrameSize(n) ||
+        entry.compressedSize > 1 + lzBound(entry.rawSize) ||
+        entry.offset < position || entry.offset > header.indexOffset ||
+        entry.compressedSize > header.indexOffset - entry.offset ||
+        entry.layer < 0 || entry.layer >= (int64_t)header.layerCount ||
+        entry.visibleDrones < 0 || (size_t)entry.visibleDrones > n)
+      return reject("has a corrupt frame index");
+    maxCompressed = std::max(maxCompressed, (size_t)entry.compressedSize);
+    maxRaw = std::max(maxRaw, (size_t)entry.rawSize);
+  }
+  for (auto &h : history)
+    h.assign(n * 3, 0);
+  colors.assign(n * 4, 0);
+  packed.reserve(maxCompressed);
+  raw.reserve(maxRaw);
+  lzOutput.reserve(lzBound(maxRaw));
+  return true;
+}
+
+void TrajectoryDecoder::close() {
+  if (file.is_open())
+    file.close();
+  file.clear();
+  header = BakeFileHeader();
+  layerNames.clear();
+  layerDurations.clear();
+  index.clear();
+  title.clear();
+  decodedFrame = -1;
+}
+
+int TrajectoryDecoder::firstFrameOfLayer(int layer) const {
+  for (size_t f = header.loopFrame; f < index.size(); ++f)
+    if (index[f].layer == layer)
+      return (int)f;
+  return -1;
+}
+
+// Decodes `frame` on top of the state left by frame - 1 (nothing for a
+// keyframe).
+bool TrajectoryDecoder::decodeNext(int frame) {
+  const BakeFrameEntry &entry = index[frame];
+  packed.resize(entry.compressedSize);
+  raw.resize(entry.rawSize);
+  file.seekg(entry.offset);
+  if (packed.empty() || !file.read((char *)packed.data(), packed.size()))
+    return false;
+  const uint8_t *lzData = packed.data() + 1;
+  size_t lzSize = packed.size() - 1;
+  if (packed[0] == BLOCK_LZ_HUFFMAN) {
+    if (!huffmanDecompress(lzData, lzSize, lzBound(entry.rawSize), lzOutput))
+      return false;
+    lzData = lzOutput.data();
+    lzSize = lzOutput.size();
+  } else if (packed[0] != BLOCK_LZ) {
+    return false;
+  }
+  if (!lzDecompress(lzData, lzSize, raw.data(), raw.size()))
+    return false;
+
+  size_t n = header.droneCount;
+  int order = predictionOrder(frame, header.keyframeInterval);
+  const uint8_t *in = raw.data(), *end = raw.data() + raw.size();
+  for (size_t j = 0; j < n * 3; ++j) {
+    uint64_t residual;
+    if (!getVarint(in, end, residual))
+      return false;
+    history[2][j] = (int32_t)(
+        predict(order, history[0][j], history[1][j], history[2][j]) +
+        unzigzag(residual));
+  }
+  rotateHistory(history);
+  if ((size_t)(end - in) != n * 4)
+    return false;
+  if (order == 0)
+    memcpy(colors.data(), in, n * 4);
+  else
+    for (size_t j = 0; j < n * 4; ++j)
+      colors[j] += in[j];
+  return true;
+}
+
+bool TrajectoryDecoder::readFrame(int frame, std::vector<DronePoint> &drones) {
+  if (frame < 0 || frame >= frameCount())
+    return false;
+  if (frame != decodedFrame) {
+    int keyframe = frame - frame % (int)header.keyframeInterval;
+    int start = decodedFrame >= keyframe && decodedFrame < frame
+                    ? decodedFrame + 1
+                    : keyframe;
+    for (int f = start; f <= frame; ++f) {
+      if (!decodeNext(f)) {
+        decodedFrame = -1;
+        return false;
+      }
+    }
+    decodedFrame = frame;
+  }
+
+  size_t n = header.droneCount;
+  if (drones.size() < n)
+    drones.resize(n);
+  float step = header.positionStep;
+  const int32_t *x = &history[0][0], *y = &history[0][n],
+                *z = &history[0][2 * n];
+  const uint8_t *r = &colors[0], *g = &colors[n], *b = &colors[2 * n],
+                *a = &colors[3 * n];
+  for (size_t i = 0; i < n; ++i) {
+    drones[i].pos = {x[i] * step, y[i] * step, z[i] * step};
+    drones[i].color = {r[i] / 255.0f, g[i] / 255.0f, b[i] / 255.0f,
+                       a[i] / 255.0f};
+  }
+  return true;
+}
+
+bool isBakedTrajectoryFile(const char *path) {
+  std::ifstream f(path, std::ios::binary);
+  char magic[4] = {0};
+  f.read(magic, 4);
+  return f && memcmp(magic, BAKE_FILE_MAGIC, 4) == 0;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "show_types.h"
+
+// --- Baked Trajectory Cache (.dbake) ---
+// A show evaluated once at a fixed frame rate, takeoff and transitions
+// included, so it can be played back, sought or handed to a fleet controller
+// without running the simulation. All values are little-endian:
+//
+//   BakeFileHeader
+//   char title[titleLength]
+//   repeated layerCount times:
+//     BakeLayerHeader
+//     char name[nameLength]
+//   frameCount compressed frame blocks
+//   BakeFrameEntry index[frameCount]   (at indexOffset)
+//
+// Positions are quantized to multiples of positionStep and colors to RGBA8.
+// Before compression a frame holds the zigzag varint residuals of every
+// drone's x, then every y, then every z, followed by the byte deltas of every
+// R, G, B and A from the previous frame. Positions are predicted: keyframes
+// (every keyframeInterval frames) predict nothing, so decoding can start
+// there; later frames extrapolate from up to three earlier ones assuming
+// constant acceleration. Drones holding a formation leave runs of zeros and
+// drones on a smooth transition path residuals of a step or two.
+//
+// The block is then packed with the small LZ coder below, which folds the
+// runs of zeros. Its first byte says whether the LZ output was additionally
+// Huffman coded, which pays off during transitions where the residuals are
+// small but rarely zero.
+const char BAKE_FILE_MAGIC[4] = {'D', 'B', 'A', 'K'};
+const uint32_t BAKE_FILE_VERSION = 1;
+// Largest fleet a file may hold, so a corrupt header cannot make the decoder
+// allocate gigabytes of frame state
+const uint32_t BAKE_MAX_DRONE_COUNT = 1 << 22;
+
+#pragma pack(push, 1)
+struct BakeFileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t droneCount;
+  uint32_t frameCount;
+  uint32_t loopFrame; // Frame after the last one when looping (past takeoff)
+  uint32_t keyframeInterval;
+  float frameRate;    // Frames per second of show time
+  float positionStep; // World units per quantization step
+  uint32_t layerCount;
+  uint32_t titleLength;
+  uint64_t indexOffset;
+};
+struct BakeLayerHeader {
+  uint32_t nameLength;
+  int32_t duration; // Milliseconds
+};
+struct BakeFrameEntry {
+  uint64_t offset;
+  uint32_t compressedSize;
+  uint32_t rawSize;
+  int32_t layer;         // Formation shown, or flown to during a transition
+  int32_t visibleDrones; // Drones that are part of the formation
+};
+#pragma pack(pop)
+
+static_assert(sizeof(BakeFileHeader) == 48, "unexpected header padding");
+static_assert(sizeof(BakeLayerHeader) == 8, "unexpected header padding");
+static_assert(sizeof(BakeFrameEntry) == 24, "unexpected entry padding");
+
+// Byte-oriented LZ77 in the spirit of LZ4: sequences of literals and
+// back-references within a 64 KiB window, lengths stored as varints so long
+// runs of zeros cost a few bytes.
+void lzCompress(const uint8_t *src, size_t size, std::vector<uint8_t> &out);
+bool lzDecompress(const uint8_t *src, size_t size, uint8_t *dst,
+                  size_t dstSize);
+
+// Writes a .dbake file one frame at a time.
+struct TrajectoryEncoder {
+  BakeFileHeader header = {};
+  uint64_t rawBytes = 0;  // Frames as float positions + RGBA8 colors
+  uint64_t fileBytes = 0; // Valid after finish()
+
+  bool open(const char *path, const DroneShow &show, int droneCount,
+            float frameRate, int keyframeInterval, float positionStep);
+  void addFrame(const std::vector<DronePoint> &drones, int layer,
+                int visibleDrones);
+  bool finish(uint32_t loopFrame);
+
+private:
+  std::ofstream file;
+  std::vector<BakeFrameEntry> index;
+  std::vector<int32_t> history[3]; // Quantized positions, newest first
+  std::vector<uint8_t> previousColors, raw, lzOutput, packed;
+};
+
+// Reads frames back from a .dbake file. Consecutive frames are decoded from
+// the previous one; any other frame from the nearest keyframe before it.
+struct TrajectoryDecoder {
+  BakeFileHeader header = {};
+  std::vector<std::string> layerNames;
+  std::vector<int> layerDurations;
+  std::vector<BakeFrameEntry> index;
+  std::string title;
+
+  bool open(const char *path, std::string &error);
+  void close();
+  bool isOpen() const { return file.is_open(); }
+  int frameCount() const { return (int)header.frameCount; }
+  // First frame after takeoff showing or flying to `layer`, or -1.
+  int firstFrameOfLayer(int layer) const;
+  // Decodes `frame` into the first droneCount entries of `drones`.
+  bool readFrame(int frame, std::vector<DronePoint> &drones);
+
+private:
+  std::ifstream file;
+  int decodedFrame = -1;
+  std::vector<int32_t> history[3]; // Quantized positions, newest first
+  std::vector<uint8_t> colors, raw, lzOutput, packed;
+  bool decodeNext(int frame);
+};
+
+bool isBakedTrajectoryFile(const char *path);
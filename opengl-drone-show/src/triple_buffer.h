@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+
+// --- Triple Buffer ---
+// Lock-free hand-off of the newest value from one writer thread to one
+// reader thread. The writer fills writeBuffer() and calls publish(); the
+// reader calls update() and then reads readBuffer(). Neither side waits for
+// the other, and the three buffers are reused, so values that keep their
+// capacity (vectors) are exchanged without allocating.
+template <typename T> struct TripleBuffer {
+  T &writeBuffer() { return buffers[back]; }
+  void publish() {
+    back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+  }
+
+  // Switches readBuffer() to the newest published value. Returns false when
+  // nothing was published since the last call.
+  bool update() {
+    if (!(middle.load(std::memory_order_relaxed) & FRESH))
+      return false;
+    front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+    return true;
+  }
+  T &readBuffer() { return buffers[front]; }
+
+private:
+  static const int INDEX = 3, FRESH = 4;
+  T buffers[3];
+  int back = 0, front = 1;
+  std::atomic<int> middle{2};
+};
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(__SSE__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define VEC_MATH_SSE 1
+#endif
+
+// --- Math & Easing ---
+// Header-only vector math shared by the viewer and its tools. Everything is
+// single precision; matrices are column-major like OpenGL expects.
+constexpr float PI = 3.1415926535f;
+
+// All types are plain floats with no extra alignment so point arrays stay
+// packed (DronePoint is 28 bytes). SIMD code loads them unaligned.
+struct Vec3 {
+  float x, y, z;
+};
+struct Vec4 {
+  float x, y, z, w;
+};
+struct Mat4 {
+  float m[16] = {0};
+};
+
+constexpr Vec3 operator+(Vec3 a, Vec3 b) {
+  return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+constexpr Vec3 operator-(Vec3 a, Vec3 b) {
+  return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+constexpr Vec3 operator*(Vec3 a, float s) {
+  return {a.x * s, a.y * s, a.z * s};
+}
+constexpr float dot(Vec3 a, Vec3 b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+constexpr Vec3 cross(Vec3 a, Vec3 b) {
+  return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+inline Vec3 normalize(Vec3 v) {
+  float mag = std::sqrt(dot(v, v));
+  if (mag > 0.0001f)
+    return v * (1.0f / mag);
+  return {0, 0, 0};
+}
+constexpr Vec3 lerp(Vec3 start, Vec3 end, float t) {
+  return start * (1.0f - t) + end * t;
+}
+constexpr Vec4 lerp(Vec4 start, Vec4 end, float t) {
+  return {start.x * (1.0f - t) + end.x * t, start.y * (1.0f - t) + end.y * t,
+          start.z * (1.0f - t) + end.z * t, start.w * (1.0f - t) + end.w * t};
+}
+constexpr float easeOutCubic(float t) {
+  float u = 1.0f - t;
+  return 1.0f - u * u * u;
+}
+// Straight-line interpolation bent sideways in the middle of the flight, in a
+// direction that depends on the drone, so paths of neighbouring drones do not
+// overlap.
+inline Vec3 naturalLerp(Vec3 start, Vec3 end, float t, int droneIndex) {
+  Vec3 lerpedPos = lerp(start, end, t);
+  if (t > 0.01f && t < 0.99f) { // Avoid deviation at start and end
+    float u = 2.0f * t - 1.0f;
+    float magnitude =
+        20.0f * (1.0f - u * u * u * u); // Strongest deviation in the middle
+
+    Vec3 path = end - start;
+    Vec3 randomDir = {std::sin(droneIndex * 2.3f), std::cos(droneIndex * 5.1f),
+                      std::sin(droneIndex * 1.7f)};
+    Vec3 perpendicular = normalize(cross(path, randomDir));
+    if (dot(perpendicular, perpendicular) <
+        0.1f) { // Handle case where path and randomDir are parallel
+      perpendicular = normalize(cross(path, {1, 0, 0}));
+      if (dot(perpendicular, perpendicular) < 0.1f) {
+        perpendicular = normalize(cross(path, {0, 1, 0}));
+      }
+    }
+
+    lerpedPos = lerpedPos + perpendicular * magnitude * std::sin(t * PI);
+  }
+  return lerpedPos;
+}
+
+constexpr Mat4 identity() {
+  Mat4 mat;
+  mat.m[0] = 1.0f;
+  mat.m[5] = 1.0f;
+  mat.m[10] = 1.0f;
+  mat.m[15] = 1.0f;
+  return mat;
+}
+constexpr Mat4 multiply(const Mat4 &a, const Mat4 &b) {
+  Mat4 mat;
+  for (int c = 0; c < 4; ++c)
+    for (int r = 0; r < 4; ++r)
+      for (int k = 0; k < 4; ++k)
+        mat.m[c * 4 + r] += a.m[k * 4 + r] * b.m[c * 4 + k];
+  return mat;
+}
+inline Mat4 perspective(float fov, float aspect, float n, float f) {
+  Mat4 mat;
+  float t = std::tan(fov / 2.0f);
+  mat.m[0] = 1.0f / (aspect * t);
+  mat.m[5] = 1.0f / t;
+  mat.m[10] = -(f + n) / (f - n);
+  mat.m[11] = -1.0f;
+  mat.m[14] = -(2.0f * f * n) / (f - n);
+  return mat;
+}
+constexpr Mat4 orthographic(float l, float r, float b, float t, float n,
+                            float f) {
+  Mat4 mat = identity();
+  mat.m[0] = 2.0f / (r - l);
+  mat.m[5] = 2.0f / (t - b);
+  mat.m[10] = -2.0f / (f - n);
+  mat.m[12] = -(r + l) / (r - l);
+  mat.m[13] = -(t + b) / (t - b);
+  mat.m[14] = -(f + n) / (f - n);
+  return mat;
+}
+inline Mat4 lookAt(Vec3 eye, Vec3 center, Vec3 up) {
+  Vec3 f = normalize(center - eye);
+  Vec3 s = normalize(cross(f, up));
+  Vec3 u = cross(s, f);
+  Mat4 mat = identity();
+  mat.m[0] = s.x;
+  mat.m[4] = s.y;
+  mat.m[8] = s.z;
+  mat.m[1] = u.x;
+  mat.m[5] = u.y;
+  mat.m[9] = u.z;
+  mat.m[2] = -f.x;
+  mat.m[6] = -f.y;
+  mat.m[10] = -f.z;
+  mat.m[12] = -dot(s, eye);
+  mat.m[13] = -dot(u, eye);
+  mat.m[14] = dot(f, eye);
+  return mat;
+}
+
+// Camera basis vectors in world space, read from the rows of a view matrix.
+constexpr Vec3 viewRight(const Mat4 &view) {
+  return {view.m[0], view.m[4], view.m[8]};
+}
+constexpr Vec3 viewUp(const Mat4 &view) {
+  return {view.m[1], view.m[5], view.m[9]};
+}
+
+// --- Batch Transforms ---
+// m * (p, 1) for a single point.
+inline Vec4 transformPoint(const Mat4 &mat, Vec3 p) {
+  const float *m = mat.m;
+  return {m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+          m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+          m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14],
+          m[3] * p.x + m[7] * p.y + m[11] * p.z + m[15]};
+}
+
+// Reference implementation of transformPoints, and the whole of it on
+// targets without SSE.
+inline void transformPointsScalar(const Mat4 &mat, const void *points,
+                                  size_t strideBytes, size_t count, Vec4 *out) {
+  const char *src = (const char *)points;
+  for (size_t i = 0; i < count; ++i, src += strideBytes)
+    out[i] = transformPoint(mat, *(const Vec3 *)src);
+}
+
+// Transforms `count` points to homogeneous coordinates. Points are Vec3s
+// found every `strideBytes` starting at `points`, so positions can be read
+// straight out of arrays of larger structs.
+inline void transformPoints(const Mat4 &mat, const void *points,
+                            size_t strideBytes, size_t count, Vec4 *out) {
+  const char *src = (const char *)points;
+  size_t i = 0;
+#if defined(VEC_MATH_SSE)
+  // One point per iteration, so every point takes this path and the scalar
+  // call below has nothing left to do. The four matrix columns stay in
+  // registers and each coordinate is broadcast across them. Gathering four
+  // points into x/y/z registers instead needs a transpose on the way in and
+  // out of the packed arrays and measured slower with --bench-math.
+  __m128 c0 = _mm_loadu_ps(&mat.m[0]);
+  __m128 c1 = _mm_loadu_ps(&mat.m[4]);
+  __m128 c2 = _mm_loadu_ps(&mat.m[8]);
+  __m128 c3 = _mm_loadu_ps(&mat.m[12]);
+  for (; i < count; ++i, src += strideBytes) {
+    const Vec3 *p = (const Vec3 *)src;
+    __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(p->x)),
+                                     _mm_mul_ps(c1, _mm_set1_ps(p->y))),
+                          _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(p->z)), c3));
+    _mm_storeu_ps(&out[i].x, r);
+  }
+#endif
+  transformPointsScalar(mat, src, strideBytes, count - i, out + i);
+}
+
+static_assert(sizeof(Vec3) == 12 && sizeof(Vec4) == 16 && sizeof(Mat4) == 64,
+              "math types must stay tightly packed");
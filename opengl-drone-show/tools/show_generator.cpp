@@ -0,0 +1,326 @@
+// Synthetic drone show generator.
+//
+// Deterministically writes a show with N drones x L layers built from
+// parametric shapes (sphere, grid, text, noise). Layer sizes can be varied so
+// the appear/disappear paths of the viewer's transitions are exercised.
+// Output is JSON (.json) or the binary format described in src/show_format.h
+// (.dshow).
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "rng.h"
+#include "show_format.h"
+
+const float PI = 3.1415926535f;
+const float SHOW_RADIUS = 250.0f;
+
+struct Point {
+  float x, y, z;
+  uint8_t r, g, b;
+};
+
+// Hue in [0, 1) to a saturated RGB color.
+void hueToRgb(float hue, Point &p) {
+  float h = (hue - floorf(hue)) * 6.0f;
+  auto channel = [](float v) {
+    return (uint8_t)(std::min(std::max(v, 0.0f), 1.0f) * 255.0f);
+  };
+  p.r = channel(fabsf(h - 3.0f) - 1.0f);
+  p.g = channel(2.0f - fabsf(h - 2.0f));
+  p.b = channel(2.0f - fabsf(h - 4.0f));
+}
+
+// --- Shapes ---
+// Evenly spread points on a sphere (Fibonacci lattice).
+void makeSphere(int count, Rng &, std::vector<Point> &out) {
+  const float goldenAngle = PI * (3.0f - sqrtf(5.0f));
+  for (int i = 0; i < count; ++i) {
+    float y = 1.0f - 2.0f * (i + 0.5f) / count;
+    float ring = sqrtf(1.0f - y * y);
+    float theta = goldenAngle * i;
+    Point p;
+    p.x = cosf(theta) * ring * SHOW_RADIUS;
+    p.y = y * SHOW_RADIUS;
+    p.z = sinf(theta) * ring * SHOW_RADIUS;
+    hueToRgb(0.5f + 0.5f * y, p);
+    out.push_back(p);
+  }
+}
+
+// Regular cubic lattice centered on the origin.
+void makeGrid(int count, Rng &, std::vector<Point> &out) {
+  int side = (int)ceil(cbrt((double)count));
+  float spacing = side > 1 ? 2.0f * SHOW_RADIUS / (side - 1) : 0.0f;
+  for (int i = 0; i < count; ++i) {
+    int gx = i % side, gy = (i / side) % side, gz = i / (side * side);
+    Point p;
+    p.x = gx * spacing - SHOW_RADIUS;
+    p.y = gy * spacing - SHOW_RADIUS;
+    p.z = gz * spacing - SHOW_RADIUS;
+    hueToRgb((float)gz / side, p);
+    out.push_back(p);
+  }
+}
+
+// 5x7 bitmap digits, one byte per row, bit 4 is the leftmost column.
+const uint8_t DIGIT_GLYPHS[10][7] = {
+    {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E},
+    {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E},
+    {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F},
+    {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E},
+    {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02},
+    {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E},
+    {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E},
+    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08},
+    {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E},
+    {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C},
+};
+
+// The layer number written in a front-facing bitmap font. Points are spread
+// evenly over the lit glyph cells and jittered inside each cell.
+void makeText(int count, int layerNumber, Rng &rng, std::vector<Point> &out) {
+  std::string text = std::to_string(layerNumber);
+  std::vector<std::pair<int, int>> cells; // (column, row) of lit cells
+  for (size_t c = 0; c < text.size(); ++c) {
+    const uint8_t *glyph = DIGIT_GLYPHS[text[c] - '0'];
+    for (int row = 0; row < 7; ++row)
+      for (int col = 0; col < 5; ++col)
+        if (glyph[row] & (0x10 >> col))
+          cells.push_back({(int)c * 6 + col, row});
+  }
+  int columns = (int)text.size() * 6 - 1;
+  float cellSize = 2.0f * SHOW_RADIUS / std::max(columns, 7);
+  for (int i = 0; i < count; ++i) {
+    const auto &cell = cells[(size_t)i * cells.size() / count];
+    Point p;
+    p.x = (cell.first + rng.uniform() - columns / 2.0f) * cellSize;
+    p.y = (3.5f - cell.second - rng.uniform()) * cellSize;
+    p.z = rng.range(-0.25f, 0.25f) * cellSize;
+    hueToRgb(0.1f * layerNumber, p);
+    out.push_back(p);
+  }
+}
+
+// Smooth value noise on an integer lattice.
+float latticeValue(int x, int z, uint32_t seed) {
+  uint32_t h = (uint32_t)x * 374761393u + (uint32_t)z * 668265263u + seed;
+  h = (h ^ (h >> 13)) * 1274126177u;
+  return ((h ^ (h >> 16)) & 0xFFFF) / 65535.0f;
+}
+float valueNoise(float x, float z, uint32_t seed) {
+  int x0 = (int)floorf(x), z0 = (int)floorf(z);
+  float tx = x - x0, tz = z - z0;
+  tx = tx * tx * (3 - 2 * tx);
+  tz = tz * tz * (3 - 2 * tz);
+  float a = latticeValue(x0, z0, seed), b = latticeValue(x0 + 1, z0, seed);
+  float c = latticeValue(x0, z0 + 1, seed);
+  float d = latticeValue(x0 + 1, z0 + 1, seed);
+  return (a + (b - a) * tx) * (1 - tz) + (c + (d - c) * tx) * tz;
+}
+
+// A rolling terrain sheet: random x/z, height from a few octaves of noise.
+void makeNoise(int count, Rng &rng, std::vector<Point> &out) {
+  uint32_t seed = (uint32_t)rng.next();
+  for (int i = 0; i < count; ++i) {
+    Point p;
+    p.x = rng.range(-SHOW_RADIUS, SHOW_RADIUS);
+    p.z = rng.range(-SHOW_RADIUS, SHOW_RADIUS);
+    float n = 0.0f, amplitude = 0.5f, frequency = 4.0f / SHOW_RADIUS;
+    for (int octave = 0; octave < 4; ++octave) {
+      n += amplitude * valueNoise(p.x * frequency, p.z * frequency, seed);
+      amplitude *= 0.5f;
+      frequency *= 2.0f;
+    }
+    p.y = (n - 0.5f) * SHOW_RADIUS;
+    hueToRgb(0.6f * n, p);
+    out.push_back(p);
+  }
+}
+
+// --- Writers ---
+// Layers are generated and written one at a time so the largest shows never
+// have to fit in memory at once.
+void writeJsonHeader(FILE *f, const std::string &title) {
+  fprintf(f, "{\n  \"title\": \"%s\",\n  \"layers\": [", title.c_str());
+}
+
+void writeJsonLayer(FILE *f, int index, const std::string &name, int duration,
+                    const std::vector<Point> &points) {
+  fprintf(f,
+          "%s\n    {\n      \"id\": \"layer_%03d\",\n      \"name\": "
+          "\"%s\",\n      \"duration\": %d,\n      \"points\": [",
+          index ? "," : "", index + 1, name.c_str(), duration);
+  for (size_t i = 0; i < points.size(); ++i) {
+    const Point &p = points[i];
+    fprintf(f,
+            "%s\n        {\"x\": %.3f, \"y\": %.3f, \"z\": %.3f, "
+            "\"color\": \"#%02x%02x%02x\"}",
+            i ? "," : "", p.x, p.y, p.z, p.r, p.g, p.b);
+  }
+  fprintf(f, "\n      ]\n    }");
+}
+
+void writeJsonFooter(FILE *f) { fprintf(f, "\n  ]\n}\n"); }
+
+void writeBinaryHeader(FILE *f, const std::string &title, int layerCount) {
+  ShowFileHeader header;
+  memcpy(header.magic, SHOW_FILE_MAGIC, 4);
+  header.version = SHOW_FILE_VERSION;
+  header.layerCount = (uint32_t)layerCount;
+  header.titleLength = (uint32_t)title.size();
+  fwrite(&header, sizeof(header), 1, f);
+  fwrite(title.data(), 1, title.size(), f);
+}
+
+void writeBinaryLayer(FILE *f, int index, const std::string &name,
+                      int duration, const std::vector<Point> &points,
+                      std::vector<ShowPointRecord> &records) {
+  char id[32];
+  snprintf(id, sizeof(id), "layer_%03d", index + 1);
+  ShowLayerHeader layerHeader;
+  layerHeader.idLength = (uint32_t)strlen(id);
+  layerHeader.nameLength = (uint32_t)name.size();
+  layerHeader.duration = duration;
+  layerHeader.pointCount = (uint32_t)points.size();
+  fwrite(&layerHeader, sizeof(layerHeader), 1, f);
+  fwrite(id, 1, layerHeader.idLength, f);
+  fwrite(name.data(), 1, name.size(), f);
+
+  records.resize(points.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    const Point &p = points[i];
+    records[i] = {p.x, p.y, p.z, p.r, p.g, p.b, 255};
+  }
+  fwrite(records.data(), sizeof(ShowPointRecord), records.size(), f);
+}
+
+void printUsage(const char *program) {
+  fprintf(stderr,
+          "Usage: %s [options] <output.json|output.dshow>\n"
+          "  --drones N      drones in the largest layer (default 10000)\n"
+          "  --layers L      number of layers (default 10)\n"
+          "  --shapes LIST   comma separated cycle of sphere,grid,text,noise\n"
+          "                  (default sphere,grid,text,noise)\n"
+          "  --vary F        layers after the first shrink by up to this\n"
+          "                  fraction, 0..1 (default 0.5)\n"
+          "  --duration MS   duration of each layer (default 3000)\n"
+          "  --seed S        random seed (default 1)\n"
+          "  --format F      json or bin (default: from the extension)\n",
+          program);
+}
+
+int main(int argc, char **argv) {
+  int drones = 10000, layerCount = 10, duration = 3000;
+  float vary = 0.5f;
+  uint64_t seed = 1;
+  std::string shapeList = "sphere,grid,text,noise", format, output;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--drones" && hasValue)
+      drones = atoi(argv[++i]);
+    else if (arg == "--layers" && hasValue)
+      layerCount = atoi(argv[++i]);
+    else if (arg == "--shapes" && hasValue)
+      shapeList = argv[++i];
+    else if (arg == "--vary" && hasValue)
+      vary = (float)atof(argv[++i]);
+    else if (arg == "--duration" && hasValue)
+      duration = atoi(argv[++i]);
+    else if (arg == "--seed" && hasValue)
+      seed = strtoull(argv[++i], NULL, 10);
+    else if (arg == "--format" && hasValue)
+      format = argv[++i];
+    else if (arg[0] != '-' && output.empty())
+      output = arg;
+    else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (output.empty() || drones <= 0 || layerCount <= 0) {
+    printUsage(argv[0]);
+    return 1;
+  }
+  if (format.empty()) {
+    bool isJson = output.size() >= 5 &&
+                  output.compare(output.size() - 5, 5, ".json") == 0;
+    format = isJson ? "json" : "bin";
+  }
+  if (format != "json" && format != "bin") {
+    fprintf(stderr, "Unknown format: %s\n", format.c_str());
+    return 1;
+  }
+
+  std::vector<std::string> shapes;
+  for (size_t start = 0; start <= shapeList.size();) {
+    size_t end = shapeList.find(',', start);
+    if (end == std::string::npos)
+      end = shapeList.size();
+    std::string shape = shapeList.substr(start, end - start);
+    if (shape != "sphere" && shape != "grid" && shape != "text" &&
+        shape != "noise") {
+      fprintf(stderr, "Unknown shape: %s\n", shape.c_str());
+      return 1;
+    }
+    shapes.push_back(shape);
+    start = end + 1;
+  }
+
+  FILE *f = fopen(output.c_str(), format == "json" ? "w" : "wb");
+  if (!f) {
+    fprintf(stderr, "Failed to open %s\n", output.c_str());
+    return 1;
+  }
+  std::string title = "Synthetic Show (" + std::to_string(drones) +
+                      " drones x " + std::to_string(layerCount) + " layers)";
+  if (format == "json")
+    writeJsonHeader(f, title);
+  else
+    writeBinaryHeader(f, title, layerCount);
+
+  std::vector<Point> points;
+  std::vector<ShowPointRecord> records;
+  size_t totalPoints = 0;
+  for (int l = 0; l < layerCount; ++l) {
+    // Every layer draws from its own stream so the output for a given seed
+    // does not depend on the other layers' sizes.
+    Rng rng(seed * 1000003ull + l);
+    int count = drones;
+    if (l > 0)
+      count = std::max(1, (int)(drones * (1.0f - vary * rng.uniform())));
+    const std::string &shape = shapes[l % shapes.size()];
+    points.clear();
+    points.reserve(count);
+    if (shape == "sphere")
+      makeSphere(count, rng, points);
+    else if (shape == "grid")
+      makeGrid(count, rng, points);
+    else if (shape == "text")
+      makeText(count, l + 1, rng, points);
+    else
+      makeNoise(count, rng, points);
+    std::string name = shape + " " + std::to_string(l + 1);
+    if (format == "json")
+      writeJsonLayer(f, l, name, duration, points);
+    else
+      writeBinaryLayer(f, l, name, duration, points, records);
+    totalPoints += count;
+  }
+  if (format == "json")
+    writeJsonFooter(f);
+  if (fclose(f) != 0) {
+    fprintf(stderr, "Failed to write %s\n", output.c_str());
+    return 1;
+  }
+  printf("Wrote %s: %d layers, %zu points\n", output.c_str(), layerCount,
+         totalPoints);
+  return 0;
+}
@@ -0,0 +1,77 @@
+#!/bin/sh
+# Scaling stress suite: generates synthetic shows of growing size, runs the
+# headless benchmark on each and collects the results into a CSV file.
+#
+# Usage (from the project root, after `make` and `make tools`):
+#   tools/stress_suite.sh [results.csv]
+#
+# Environment overrides:
+#   DRONES   drone counts to test      (default "10000 100000 1000000")
+#   LAYERS   layer counts to test      (default "1 20 200")
+#   FORMATS  input formats             (default "json bin")
+#   JSON_MAX_POINTS  skip JSON above this many total points (default 2000000)
+#   FRAMES / SEEKS   passed to --bench (default 600 / 20)
+#   WORK_DIR where shows are written   (default /tmp/drone-stress)
+#
+# The largest case (1M drones x 200 layers) needs ~3.2 GB of disk for the
+# binary show (16 B per point) and ~5.6 GB of memory once loaded (28 B per
+# DronePoint). Cases whose estimated footprint exceeds MemAvailable are
+# skipped on Linux; elsewhere every case runs.
+
+set -e
+
+RESULTS=${1:-stress_results.csv}
+DRONES=${DRONES:-"10000 100000 1000000"}
+LAYERS=${LAYERS:-"1 20 200"}
+FORMATS=${FORMATS:-"json bin"}
+JSON_MAX_POINTS=${JSON_MAX_POINTS:-2000000}
+FRAMES=${FRAMES:-600}
+SEEKS=${SEEKS:-20}
+WORK_DIR=${WORK_DIR:-/tmp/drone-stress}
+
+VIEWER=./drone_show
+GENERATOR=./show_generator
+[ -x "$VIEWER" ] || VIEWER=./drone_show.exe
+[ -x "$GENERATOR" ] || GENERATOR=./show_generator.exe
+
+# Free memory in MB, empty where /proc/meminfo does not exist
+avail_mb=$(awk '/^MemAvailable:/ { print int($2 / 1024) }' /proc/meminfo 2>/dev/null || true)
+
+mkdir -p "$WORK_DIR"
+echo "format,drones,layers,file_mb,load_ms,peak_rss_mb,frames,update_mean_ms,update_p99_ms,update_max_ms" > "$RESULTS"
+
+for drones in $DRONES; do
+  for layers in $LAYERS; do
+    # Loaded points plus 10% arena slack and ~256 MB for everything else
+    need_mb=$((drones * layers * 28 / 1048576 * 11 / 10 + 256))
+    if [ -n "$avail_mb" ] && [ "$need_mb" -gt "$avail_mb" ]; then
+      echo "skip ${drones}x${layers} (needs ~${need_mb} MB, ${avail_mb} MB available)"
+      continue
+    fi
+    for format in $FORMATS; do
+      if [ "$format" = json ]; then
+        if [ $((drones * layers)) -gt "$JSON_MAX_POINTS" ]; then
+          echo "skip json ${drones}x${layers} (above JSON_MAX_POINTS)"
+          continue
+        fi
+        show="$WORK_DIR/show_${drones}x${layers}.json"
+      else
+        show="$WORK_DIR/show_${drones}x${layers}.dshow"
+      fi
+
+      "$GENERATOR" --drones "$drones" --layers "$layers" --seed 1 "$show"
+      file_mb=$(du -m "$show" | cut -f1)
+      line=$("$VIEWER" --bench "$show" --frames "$FRAMES" --seeks "$SEEKS")
+      echo "$line"
+      echo "$line" | awk -v fmt="$format" -v mb="$file_mb" '{
+        for (i = 2; i <= NF; ++i) { split($i, kv, "="); v[kv[1]] = kv[2] }
+        printf "%s,%s,%s,%s,%s,%s,%s,%s,%s,%s\n", fmt, v["drones"],
+               v["layers"], mb, v["load_ms"], v["peak_rss_mb"], v["frames"],
+               v["update_mean_ms"], v["update_p99_ms"], v["update_max_ms"]
+      }' >> "$RESULTS"
+      rm -f "$show"
+    done
+  done
+done
+
+echo "Results written to $RESULTS"